@@ -0,0 +1,54 @@
+# Minimal perfect hash of event names, see tools/hsm_event_hash.c
+#
+# hsm_event_hash(<target> <header> <enum> <prefix>)
+# Generates <enum without _t>_hash.h in the current binary directory from the enum
+# defined in header, and adds it to the target. Only the members starting with the
+# prefix are included.
+#
+# The generator runs on the build host. It is built with the target toolchain for native
+# builds. When cross compiling, it is built as a separate host project using the default
+# compiler of the host, or set HSM_EVENT_HASH_EXECUTABLE to a prebuilt generator.
+
+set(HSM_EVENT_HASH_SOURCE ${CMAKE_CURRENT_LIST_DIR}/../tools/hsm_event_hash.c)
+set(HSM_EVENT_HASH_TOOLS ${CMAKE_CURRENT_LIST_DIR}/../tools)
+set(HSM_EVENT_HASH_EXECUTABLE "" CACHE FILEPATH "Prebuilt hsm_event_hash generator that runs on the build host")
+
+function(hsm_event_hash TARGET HEADER ENUM PREFIX)
+	# Generator is built once for all the targets
+	if(HSM_EVENT_HASH_EXECUTABLE)
+		set(GENERATOR ${HSM_EVENT_HASH_EXECUTABLE})
+		set(GENERATOR_DEPENDS ${HSM_EVENT_HASH_EXECUTABLE})
+	elseif(CMAKE_CROSSCOMPILING)
+		set(HOST_DIR ${CMAKE_BINARY_DIR}/hsm_event_hash_host)
+		set(GENERATOR ${HOST_DIR}/hsm_event_hash${CMAKE_HOST_EXECUTABLE_SUFFIX})
+		if(NOT TARGET hsm_event_hash_host)
+			include(ExternalProject)
+			# Toolchain file of target is not passed, so the host compiler is used.
+			ExternalProject_Add(hsm_event_hash_host
+				SOURCE_DIR ${HSM_EVENT_HASH_TOOLS}
+				BINARY_DIR ${HOST_DIR}
+				CMAKE_ARGS -DCMAKE_BUILD_TYPE=Release
+				INSTALL_COMMAND ""
+				BUILD_BYPRODUCTS ${GENERATOR}
+				)
+		endif()
+		set(GENERATOR_DEPENDS hsm_event_hash_host ${GENERATOR})
+	else()
+		if(NOT TARGET hsm_event_hash)
+			add_executable(hsm_event_hash ${HSM_EVENT_HASH_SOURCE})
+		endif()
+		set(GENERATOR hsm_event_hash)
+		set(GENERATOR_DEPENDS hsm_event_hash)
+	endif()
+
+	string(REGEX REPLACE "_t$" "" NAME ${ENUM})
+	set(OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/${NAME}_hash.h)
+	add_custom_command(
+		OUTPUT ${OUTPUT}
+		COMMAND ${GENERATOR} ${HEADER} ${ENUM} ${PREFIX} ${OUTPUT}
+		DEPENDS ${GENERATOR_DEPENDS} ${HEADER}
+		COMMENT "Generating perfect hash of ${ENUM} names"
+		)
+	target_sources(${TARGET} PRIVATE ${OUTPUT})
+	target_include_directories(${TARGET} PRIVATE ${CMAKE_CURRENT_BINARY_DIR})
+endfunction()
@@ -0,0 +1,59 @@
+#ifndef BENCH_COMMAND_H
+#define BENCH_COMMAND_H
+
+/**
+ * \file
+ * \brief Commands of control protocol used by event_decode benchmark
+
+ * \author  Nandkishor Biradar
+ * \date    19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+/*
+ *  --------------------- ENUMERATION ---------------------
+ */
+
+//! List of commands
+typedef enum
+{
+  CMD_START = 1,
+  CMD_STOP,
+  CMD_PAUSE,
+  CMD_RESUME,
+  CMD_RESET,
+  CMD_DOOR_OPEN,
+  CMD_DOOR_CLOSE,
+  CMD_DOOR_LOCK,
+  CMD_DOOR_UNLOCK,
+  CMD_LAMP_ON,
+  CMD_LAMP_OFF,
+  CMD_FAN_ON,
+  CMD_FAN_OFF,
+  CMD_HEATER_ON,
+  CMD_HEATER_OFF,
+  CMD_GRILL_ON,
+  CMD_GRILL_OFF,
+  CMD_SET_TEMPERATURE,
+  CMD_SET_TIMER,
+  CMD_ADD_MINUTE,
+  CMD_CLEAR_TIMER,
+  CMD_GET_STATUS,
+  CMD_GET_TEMPERATURE,
+  CMD_GET_TIMER,
+  CMD_SELF_TEST,
+  CMD_CALIBRATE,
+  CMD_CHILD_LOCK,
+  CMD_CHILD_UNLOCK,
+  CMD_FIRMWARE_UPDATE,
+  CMD_FACTORY_RESET,
+  CMD_SLEEP,
+  CMD_WAKEUP,
+}command_event_t;
+
+#endif // BENCH_COMMAND_H
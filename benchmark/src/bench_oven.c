@@ -0,0 +1,206 @@
+/**
+ * \file
+ * \brief Toaster oven state machine used by benchmarks.
+ *  Same topology as the toaster oven demo without console output.
+
+ * \author  Nandkishor Biradar
+ * \date    19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+/*
+ *  --------------------- INCLUDE FILES ---------------------
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "hsm.h"
+#include "bench_oven.h"
+
+/*
+ *  --------------------- ENUMERATION ---------------------
+ */
+
+//! List of states in oven state machine
+typedef enum
+{
+  DOOR_OPEN_STATE,
+  DOOR_CLOSE_STATE,
+}oven_state_t;
+
+//! List of states in door closed states machine
+typedef enum
+{
+  OFF_STATE,
+  ON_STATE,
+  TOTAL_DOOR_CLOSED_STATES
+}door_close_state_t;
+
+/*
+ *  --------------------- Function prototype ---------------------
+ */
+
+static state_machine_result_t door_open_handler(state_machine_t* const pState);
+static state_machine_result_t door_open_entry_handler(state_machine_t* const pState);
+
+static state_machine_result_t door_close_handler(state_machine_t* const pState);
+static state_machine_result_t door_close_entry_handler(state_machine_t* const pState);
+
+static state_machine_result_t off_handler(state_machine_t* const pState);
+static state_machine_result_t on_handler(state_machine_t* const pState);
+static state_machine_result_t on_entry_handler(state_machine_t* const pState);
+static state_machine_result_t on_exit_handler(state_machine_t* const pState);
+
+/*
+ *  --------------------- Global variables ---------------------
+ */
+
+static const state_t Door_Close_State[TOTAL_DOOR_CLOSED_STATES];
+
+//! List of all the states
+static const state_t Oven_State[] =
+{
+  [DOOR_OPEN_STATE] = {
+    .Handler  = door_open_handler,
+    .Entry    = door_open_entry_handler,
+  },
+  [DOOR_CLOSE_STATE] = {
+    .Handler  = door_close_handler,
+    .Entry    = door_close_entry_handler,
+    .Node     = Door_Close_State,
+  },
+};
+
+static const state_t Door_Close_State[TOTAL_DOOR_CLOSED_STATES] =
+{
+  [OFF_STATE] = {
+    .Handler  = off_handler,
+    .Parent   = &Oven_State[DOOR_CLOSE_STATE],
+    .Level    = 1,
+  },
+  [ON_STATE] = {
+    .Handler  = on_handler,
+    .Entry    = on_entry_handler,
+    .Exit     = on_exit_handler,
+    .Parent   = &Oven_State[DOOR_CLOSE_STATE],
+    .Level    = 1,
+  },
+};
+
+/*
+ *  --------------------- Functions ---------------------
+ */
+
+void init_bench_oven(bench_oven_t* const pOven, uint32_t toastTime)
+{
+  set_state(&pOven->Machine, &Door_Close_State[OFF_STATE]);
+  pOven->Machine.Event = 0;
+  pOven->Set_Time = toastTime;
+  pOven->Resume_Time = 0;
+  pOven->Timer = 0;
+  pOven->Lamp = false;
+  pOven->Heater = false;
+}
+
+static state_machine_result_t door_open_handler(state_machine_t* const pState)
+{
+  bench_oven_t* const pOven = (bench_oven_t*)pState;
+  switch(pState->Event)
+  {
+  case BENCH_DOOR_CLOSE:
+    if(pOven->Resume_Time)
+    {
+      return traverse_state(pState, &Door_Close_State[ON_STATE]);
+    }
+    return traverse_state(pState, &Door_Close_State[OFF_STATE]);
+
+  default:
+    // Oven ignores all other events when door is open.
+    return EVENT_HANDLED;
+  }
+}
+
+static state_machine_result_t door_open_entry_handler(state_machine_t* const pState)
+{
+  ((bench_oven_t*)pState)->Lamp = true;
+  return EVENT_HANDLED;
+}
+
+static state_machine_result_t door_close_handler(state_machine_t* const pState)
+{
+  // Events not handled by substates are ignored.
+  (void)(pState);
+  return EVENT_HANDLED;
+}
+
+static state_machine_result_t door_close_entry_handler(state_machine_t* const pState)
+{
+  ((bench_oven_t*)pState)->Lamp = false;
+  return EVENT_HANDLED;
+}
+
+static state_machine_result_t off_handler(state_machine_t* const pState)
+{
+  bench_oven_t* const pOven = (bench_oven_t*)pState;
+  switch(pState->Event)
+  {
+  case BENCH_START:
+    pOven->Timer = pOven->Set_Time;
+    pOven->Resume_Time = 0;
+    return switch_state(pState, &Door_Close_State[ON_STATE]);
+
+  case BENCH_DOOR_OPEN:
+    return traverse_state(pState, &Oven_State[DOOR_OPEN_STATE]);
+
+  default:
+    return EVENT_UN_HANDLED;
+  }
+}
+
+static state_machine_result_t on_handler(state_machine_t* const pState)
+{
+  bench_oven_t* const pOven = (bench_oven_t*)pState;
+  switch(pState->Event)
+  {
+  case BENCH_STOP:
+    pOven->Timer = 0;
+    pOven->Resume_Time = 0;
+    return switch_state(pState, &Door_Close_State[OFF_STATE]);
+
+  case BENCH_TIMEOUT:
+    return switch_state(pState, &Door_Close_State[OFF_STATE]);
+
+  case BENCH_DOOR_OPEN:
+    pOven->Resume_Time = pOven->Timer;
+    pOven->Timer = 0;
+    return traverse_state(pState, &Oven_State[DOOR_OPEN_STATE]);
+
+  default:
+    return EVENT_UN_HANDLED;
+  }
+}
+
+static state_machine_result_t on_entry_handler(state_machine_t* const pState)
+{
+  bench_oven_t* const pOven = (bench_oven_t*)pState;
+  pOven->Heater = true;
+
+  if(pOven->Resume_Time)
+  {
+    pOven->Timer = pOven->Resume_Time;
+    pOven->Resume_Time = 0;
+  }
+  return EVENT_HANDLED;
+}
+
+static state_machine_result_t on_exit_handler(state_machine_t* const pState)
+{
+  ((bench_oven_t*)pState)->Heater = false;
+  return EVENT_HANDLED;
+}
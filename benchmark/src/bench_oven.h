@@ -0,0 +1,55 @@
+#ifndef BENCH_OVEN_H
+#define BENCH_OVEN_H
+
+/**
+ * \file
+ * \brief Toaster oven state machine used by benchmarks.
+ *  Same topology as the toaster oven demo without console output.
+
+ * \author  Nandkishor Biradar
+ * \date    19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+/*
+ *  --------------------- ENUMERATION ---------------------
+ */
+
+//! List of oven events
+typedef enum
+{
+  BENCH_START = 1,
+  BENCH_STOP,
+  BENCH_DOOR_OPEN,
+  BENCH_DOOR_CLOSE,
+  BENCH_TIMEOUT,
+  TOTAL_BENCH_EVENTS = BENCH_TIMEOUT
+}bench_event_t;
+
+/*
+ *  --------------------- STRUCTURE ---------------------
+ */
+
+//! Oven state machine
+typedef struct
+{
+  state_machine_t Machine;  //!< Abstract state machine
+  uint32_t Set_Time;        //!< Set time of a oven
+  uint32_t Resume_Time;     //!< Remaining time when the oven is paused
+  uint32_t Timer;           //!< Oven timer
+  bool Lamp;                //!< Oven lamp
+  bool Heater;              //!< Oven heater
+}bench_oven_t;
+
+/*
+ *  --------------------- External function prototype ---------------------
+ */
+
+extern void init_bench_oven(bench_oven_t* const pOven, uint32_t toastTime);
+
+#endif // BENCH_OVEN_H
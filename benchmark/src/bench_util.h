@@ -0,0 +1,48 @@
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+/**
+ * \file
+ * \brief Common helpers of benchmarks
+
+ * \author  Nandkishor Biradar
+ * \date    19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+/*
+ *  --------------------- INCLUDE FILES ---------------------
+ */
+
+#include <stdint.h>
+#include <time.h>
+
+/*
+ *  --------------------- Inline functions ---------------------
+ */
+
+//! Returns monotonic time in nanoseconds.
+static inline uint64_t bench_now_ns(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+//! xorshift32 pseudo random number generator. Seed must be non-zero.
+static inline uint32_t bench_random(uint32_t* const pSeed)
+{
+  uint32_t x = *pSeed;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *pSeed = x;
+  return x;
+}
+
+#endif // BENCH_UTIL_H
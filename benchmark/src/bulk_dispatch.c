@@ -0,0 +1,133 @@
+/**
+ * \file
+ * \brief Throughput of bulk transition engine.
+ *
+ *  Usage: bulk_dispatch [instances] [rounds]
+ *  Applies fleet wide events to all the instances of a flat state machine.
+ *  Build with -DBENCHMARK_NATIVE=ON to use AVX2/AVX-512 gather.
+
+ * \author  Nandkishor Biradar
+ * \date    19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+/*
+ *  --------------------- INCLUDE FILES ---------------------
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hsm_bulk.h"
+#include "bench_util.h"
+
+/*
+ *  --------------------- DEFINITION ---------------------
+ */
+
+#define DEFAULT_INSTANCES   (4u * 1024u * 1024u)
+#define DEFAULT_ROUNDS      20
+
+/*
+ *  --------------------- ENUMERATION ---------------------
+ */
+
+//! States of a device in the fleet
+enum
+{
+  IDLE,
+  ONLINE,
+  UPDATING,
+  OFFLINE,
+  TOTAL_STATES
+};
+
+//! Fleet wide events
+enum
+{
+  EN_CONNECT,
+  EN_ROLLOUT,
+  EN_ROLLOUT_DONE,
+  EN_DISCONNECT,
+  TOTAL_EVENTS
+};
+
+/*
+ *  --------------------- Global variables ---------------------
+ */
+
+static const uint16_t Transition[TOTAL_EVENTS * TOTAL_STATES] =
+{
+  // IDLE     ONLINE    UPDATING  OFFLINE
+  ONLINE,     ONLINE,   UPDATING, OFFLINE,    // EN_CONNECT
+  IDLE,       UPDATING, UPDATING, OFFLINE,    // EN_ROLLOUT
+  IDLE,       ONLINE,   ONLINE,   OFFLINE,    // EN_ROLLOUT_DONE
+  OFFLINE,    OFFLINE,  UPDATING, OFFLINE,    // EN_DISCONNECT
+};
+
+static uint32_t Updates;
+
+/*
+ *  --------------------- Functions ---------------------
+ */
+
+static void updating_entry(uint32_t instance)
+{
+  (void)(instance);
+  Updates++;
+}
+
+static const bulk_action Entry[TOTAL_STATES] = {NULL, NULL, updating_entry, NULL};
+
+static const bulk_state_table_t Table =
+{
+  .Transition = Transition,
+  .Entry      = Entry,
+  .Exit       = NULL,
+  .States     = TOTAL_STATES,
+  .Events     = TOTAL_EVENTS,
+};
+
+int main(int argc, char* argv[])
+{
+  uint32_t instances = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : DEFAULT_INSTANCES;
+  uint32_t rounds = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : DEFAULT_ROUNDS;
+
+  uint16_t* pState = malloc(sizeof(uint16_t) * instances);
+  if(pState == NULL)
+  {
+    printf("out of memory\n");
+    return EXIT_FAILURE;
+  }
+
+  // Random initial states, so that every event changes only part of the fleet.
+  uint32_t seed = 0x2545F491u;
+  for(uint32_t index = 0; index < instances; index++)
+  {
+    pState[index] = (uint16_t)(bench_random(&seed) % TOTAL_STATES);
+  }
+
+  static const uint16_t events[] = {EN_CONNECT, EN_ROLLOUT, EN_ROLLOUT_DONE, EN_DISCONNECT};
+  uint64_t changed = 0;
+  uint64_t start = bench_now_ns();
+  for(uint32_t round = 0; round < rounds; round++)
+  {
+    changed += bulk_dispatch_event(&Table, pState, instances,
+                                   events[round % (sizeof(events)/sizeof(events[0]))]);
+  }
+  uint64_t elapsed = bench_now_ns() - start;
+
+  printf("instances: %u, rounds: %u, changed: %llu, updates: %u\n",
+         instances, rounds, (unsigned long long)changed, Updates);
+  printf("bulk_dispatch_event: %.2f ms per event, %.0f M instances/s\n",
+         (double)elapsed / 1e6 / rounds, (double)instances * rounds * 1e3 / (double)elapsed);
+
+  free(pState);
+  return EXIT_SUCCESS;
+}
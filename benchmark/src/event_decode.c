@@ -0,0 +1,146 @@
+/**
+ * \file
+ * \brief Decoding of event names using the perfect hash generated by hsm_event_hash.
+ *
+ *  Usage: event_decode [names] [seed]
+ *  Decodes a random stream of names, with one in eight unknown names, using the decoder
+ *  generated by hsm_event_hash and a linear scan of the names, like a handwritten chain of
+ *  string compares. It uses 5 oven events and 32 commands of a control protocol.
+
+ * \author  Nandkishor Biradar
+ * \date    19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+/*
+ *  --------------------- INCLUDE FILES ---------------------
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hsm.h"
+#include "bench_oven.h"
+#include "bench_command.h"
+#include "bench_event_hash.h"
+#include "command_event_hash.h"
+#include "bench_util.h"
+
+/*
+ *  --------------------- DEFINITION ---------------------
+ */
+
+#define DEFAULT_NAMES   (16u * 1024u * 1024u)
+#define DEFAULT_SEED    2463534242u
+
+//! Number of names in the input stream, it is a power of two.
+#define STREAM_SIZE     4096u
+
+//! Decodes the stream using the given decoder and returns the elapsed time in nanoseconds.
+//! It is a macro, so that the decoder is inlined.
+#define RUN_DECODER(decode, names, pSum)                                  \
+  do                                                                      \
+  {                                                                       \
+    uint64_t sum = 0;                                                     \
+    const uint64_t start = bench_now_ns();                                \
+    for(uint32_t count = 0; count < (names); count++)                     \
+    {                                                                     \
+      const uint32_t index = count & (STREAM_SIZE - 1);                   \
+      sum += decode(Stream[index], Stream_Length[index]);                 \
+    }                                                                     \
+    elapsed = bench_now_ns() - start;                                     \
+    *(pSum) += sum;                                                       \
+  }while(0)
+
+/*
+ *  --------------------- Global variables ---------------------
+ */
+
+static const char* Stream[STREAM_SIZE];
+static size_t Stream_Length[STREAM_SIZE];
+
+/*
+ *  --------------------- Functions ---------------------
+ */
+
+//! Linear scan of oven event names, like a handwritten chain of compares.
+static inline uint32_t scan_bench_event(const char* const pName, size_t length)
+{
+  for(uint32_t index = 0; index < BENCH_EVENT_NAMES; index++)
+  {
+    if((Bench_Event_Length[index] == length) && (memcmp(Bench_Event_Name[index], pName, length) == 0))
+    {
+      return Bench_Event_Value[index];
+    }
+  }
+  return 0;
+}
+
+//! Linear scan of command names, like a handwritten chain of compares.
+static inline uint32_t scan_command_event(const char* const pName, size_t length)
+{
+  for(uint32_t index = 0; index < COMMAND_EVENT_NAMES; index++)
+  {
+    if((Command_Event_Length[index] == length) && (memcmp(Command_Event_Name[index], pName, length) == 0))
+    {
+      return Command_Event_Value[index];
+    }
+  }
+  return 0;
+}
+
+//! Fill the stream with random names of the table and one in eight unknown names.
+static void fill_stream(const char* const* const pNames, uint32_t total, uint32_t* const pSeed)
+{
+  static const char* const Unknown[] = {"door", "reboot", "start_now", "x"};
+  for(uint32_t index = 0; index < STREAM_SIZE; index++)
+  {
+    const uint32_t random = bench_random(pSeed);
+    Stream[index] = ((random & 7) == 0) ? Unknown[(random >> 3) & 3] : pNames[(random >> 3) % total];
+    Stream_Length[index] = strlen(Stream[index]);
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  const uint32_t names = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : DEFAULT_NAMES;
+  uint32_t seed = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : DEFAULT_SEED;
+  if((names == 0) || (seed == 0))
+  {
+    printf("usage: event_decode [names] [seed]\n");
+    return EXIT_FAILURE;
+  }
+
+  uint64_t hashSum = 0;
+  uint64_t scanSum = 0;
+  uint64_t elapsed;
+  printf("names: %u\n", names);
+  printf("%-14s %14s %14s\n", "ns/name", "perfect hash", "linear scan");
+
+  fill_stream(Bench_Event_Name, BENCH_EVENT_NAMES, &seed);
+  RUN_DECODER(decode_bench_event, names, &hashSum);
+  printf("%-14s %14.2f", "5 events", (double)elapsed / names);
+  RUN_DECODER(scan_bench_event, names, &scanSum);
+  printf(" %14.2f\n", (double)elapsed / names);
+
+  fill_stream(Command_Event_Name, COMMAND_EVENT_NAMES, &seed);
+  RUN_DECODER(decode_command_event, names, &hashSum);
+  printf("%-14s %14.2f", "32 commands", (double)elapsed / names);
+  RUN_DECODER(scan_command_event, names, &scanSum);
+  printf(" %14.2f\n", (double)elapsed / names);
+
+  if(hashSum != scanSum)
+  {
+    printf("decoders differ\n");
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,213 @@
+/**
+ * \file
+ * \brief Memory and throughput of a fleet of hierarchical state machines.
+ *
+ *  Usage: fleet_stress [instances] [events] [seed]
+ *  Creates the instances of toaster oven state machine from a pool, posts a random
+ *  stream of events to random instances and reports the resident memory per instance,
+ *  the throughput and the latency percentiles of dispatch. Resident memory is read from
+ *  /proc/self/statm, it is reported as 0 on other systems.
+
+ * \author  Nandkishor Biradar
+ * \date    19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+/*
+ *  --------------------- INCLUDE FILES ---------------------
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hsm.h"
+#include "hsm_post.h"
+#include "hsm_pool.h"
+#include "bench_oven.h"
+#include "bench_util.h"
+
+/*
+ *  --------------------- DEFINITION ---------------------
+ */
+
+#define DEFAULT_INSTANCES   (1024u * 1024u)
+#define DEFAULT_EVENTS      (16u * 1024u * 1024u)
+#define DEFAULT_SEED        2463534242u
+
+//! Number of events posted before each dispatch in throughput run.
+#define BATCH_SIZE          4096u
+
+//! Maximum number of latency samples.
+#define MAX_SAMPLES         (1024u * 1024u)
+
+/*
+ *  --------------------- Global variables ---------------------
+ */
+
+static state_machine_t* Batch[BATCH_SIZE];
+
+/*
+ *  --------------------- Functions ---------------------
+ */
+
+//! Returns the resident memory of process in bytes, 0 if it is not available.
+static uint64_t resident_bytes(void)
+{
+  unsigned long long size = 0;
+  unsigned long long resident = 0;
+  FILE* const pFile = fopen("/proc/self/statm", "r");
+  if(pFile == NULL)
+  {
+    return 0;
+  }
+  if(fscanf(pFile, "%llu %llu", &size, &resident) != 2)
+  {
+    resident = 0;
+  }
+  fclose(pFile);
+  return resident * 4096u;
+}
+
+static int compare(const void* pFirst, const void* pSecond)
+{
+  const uint32_t first = *(const uint32_t*)pFirst;
+  const uint32_t second = *(const uint32_t*)pSecond;
+  return (first > second) - (first < second);
+}
+
+//! Returns a random event of oven.
+static inline uint32_t random_event(uint32_t* const pSeed)
+{
+  return (bench_random(pSeed) % TOTAL_BENCH_EVENTS) + 1;
+}
+
+//! Posts batches of random events to random instances and dispatches them using dispatch_event_grouped,
+//! as dispatch_event restarts from the first instance after each event. Returns the number of dispatched events.
+static uint64_t run_throughput(state_machine_t* const pMachine[], uint32_t instances, uint32_t events, uint32_t* const pSeed)
+{
+  uint64_t dispatched = 0;
+  uint32_t posted = 0;
+
+  while(posted < events)
+  {
+    uint32_t batch = 0;
+    while((batch < BATCH_SIZE) && (posted < events))
+    {
+      state_machine_t* const pState_Machine = pMachine[bench_random(pSeed) % instances];
+      posted++;
+      // Instance with a pending event is already in the batch.
+      if(post_event(pState_Machine, random_event(pSeed), NULL))
+      {
+        Batch[batch++] = pState_Machine;
+      }
+    }
+
+    if(dispatch_event_grouped(Batch, batch) != EVENT_HANDLED)
+    {
+      printf("dispatch failed\n");
+      exit(EXIT_FAILURE);
+    }
+    dispatched += batch;
+  }
+  return dispatched;
+}
+
+//! Measures the latency of posting and dispatching single event to a random instance.
+static void run_latency(state_machine_t* const pMachine[], uint32_t instances,
+                        uint32_t* const pLatency, uint32_t samples, uint32_t* const pSeed)
+{
+  for(uint32_t count = 0; count < samples; count++)
+  {
+    state_machine_t* const pState_Machine = pMachine[bench_random(pSeed) % instances];
+    const uint32_t event = random_event(pSeed);
+
+    const uint64_t start = bench_now_ns();
+    post_event(pState_Machine, event, NULL);
+    dispatch_event(&pState_Machine, 1);
+    pLatency[count] = (uint32_t)(bench_now_ns() - start);
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  const uint32_t instances = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : DEFAULT_INSTANCES;
+  const uint32_t events = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : DEFAULT_EVENTS;
+  uint32_t seed = (argc > 3) ? (uint32_t)strtoul(argv[3], NULL, 0) : DEFAULT_SEED;
+  if((instances == 0) || (events == 0) || (seed == 0))
+  {
+    printf("usage: fleet_stress [instances] [events] [seed]\n");
+    return EXIT_FAILURE;
+  }
+
+  const uint32_t samples = (events < MAX_SAMPLES) ? events : MAX_SAMPLES;
+  const size_t poolSize = MACHINE_POOL_SIZE(sizeof(bench_oven_t), instances);
+  state_machine_t** const pMachine = malloc((size_t)instances * sizeof(pMachine[0]));
+  uint32_t* const pLatency = malloc((size_t)samples * sizeof(pLatency[0]));
+  if((pMachine == NULL) || (pLatency == NULL))
+  {
+    printf("out of memory\n");
+    return EXIT_FAILURE;
+  }
+
+  // Pointer array is touched before the baseline, so that only the pool is measured.
+  for(uint32_t index = 0; index < instances; index++)
+  {
+    pMachine[index] = NULL;
+  }
+  const uint64_t baseline = resident_bytes();
+
+  void* const pMemory = aligned_alloc(HSM_POOL_CACHE_LINE, poolSize);
+  machine_pool_t pool;
+  if((pMemory == NULL) || !init_machine_pool(&pool, pMemory, sizeof(bench_oven_t), instances))
+  {
+    printf("out of memory\n");
+    return EXIT_FAILURE;
+  }
+
+  // Initial state of oven is set by init_bench_oven.
+  bench_oven_t oven;
+  init_bench_oven(&oven, 100);
+
+  uint64_t start = bench_now_ns();
+  create_machines(&pool, pMachine, instances, get_state(&oven.Machine));
+  for(uint32_t index = 0; index < instances; index++)
+  {
+    init_bench_oven((bench_oven_t*)pMachine[index], 100);
+  }
+  const uint64_t created = bench_now_ns() - start;
+  const uint64_t resident = resident_bytes();
+
+  start = bench_now_ns();
+  const uint64_t dispatched = run_throughput(pMachine, instances, events, &seed);
+  const uint64_t elapsed = bench_now_ns() - start;
+
+  run_latency(pMachine, instances, pLatency, samples, &seed);
+  qsort(pLatency, samples, sizeof(pLatency[0]), compare);
+
+  printf("instances: %u, posted events: %u, dispatched events: %llu\n",
+         instances, events, (unsigned long long)dispatched);
+  printf("slot size           : %u bytes (instance %u bytes)\n",
+         (unsigned)pool.Slot_Size, (unsigned)sizeof(bench_oven_t));
+  printf("resident memory     : %.1f bytes/instance\n",
+         (resident > baseline) ? (double)(resident - baseline) / instances : 0.0);
+  printf("create              : %.1f ns/instance\n", (double)created / instances);
+  printf("throughput (grouped): %.0f events/s\n", (double)dispatched * 1e9 / (double)elapsed);
+  printf("%-19s %10s %10s %10s %10s\n", "latency (ns)", "p50", "p99", "p99.9", "max");
+  printf("%-19s %10u %10u %10u %10u\n", "post + dispatch",
+         pLatency[samples / 2],
+         pLatency[((uint64_t)samples * 99) / 100],
+         pLatency[((uint64_t)samples * 999) / 1000],
+         pLatency[samples - 1]);
+
+  free(pMemory);
+  free(pLatency);
+  free(pMachine);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,107 @@
+/**
+ * \file
+ * \brief Throughput of dispatch_event_grouped compared to dispatch_event.
+ *
+ *  Usage: grouped_dispatch [instances] [rounds]
+ *  In each round a random event is posted to every oven and then all
+ *  the events are dispatched. Both dispatchers see the same event stream.
+
+ * \author  Nandkishor Biradar
+ * \date    19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+/*
+ *  --------------------- INCLUDE FILES ---------------------
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hsm.h"
+#include "bench_oven.h"
+#include "bench_util.h"
+
+/*
+ *  --------------------- DEFINITION ---------------------
+ */
+
+#define DEFAULT_INSTANCES   4096
+#define DEFAULT_ROUNDS      200
+
+/*
+ *  --------------------- Functions ---------------------
+ */
+
+typedef state_machine_result_t (*dispatcher_t)(state_machine_t* const pState_Machine[], uint32_t quantity);
+
+/** \brief Runs the event stream on fresh set of ovens using given dispatcher.
+ *
+ * \return uint64_t total dispatch time in nanoseconds.
+ */
+static uint64_t run(dispatcher_t dispatcher, bench_oven_t* pOven,
+                    state_machine_t** pMachines, uint32_t instances, uint32_t rounds)
+{
+  uint32_t seed = 0x2545F491u;
+  uint64_t elapsed = 0;
+
+  for(uint32_t index = 0; index < instances; index++)
+  {
+    init_bench_oven(&pOven[index], 10);
+  }
+
+  for(uint32_t round = 0; round < rounds; round++)
+  {
+    for(uint32_t index = 0; index < instances; index++)
+    {
+      pOven[index].Machine.Event = 1 + bench_random(&seed) % TOTAL_BENCH_EVENTS;
+    }
+
+    uint64_t start = bench_now_ns();
+    if(dispatcher(pMachines, instances) != EVENT_HANDLED)
+    {
+      printf("dispatch failed\n");
+      exit(EXIT_FAILURE);
+    }
+    elapsed += bench_now_ns() - start;
+  }
+  return elapsed;
+}
+
+int main(int argc, char* argv[])
+{
+  uint32_t instances = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : DEFAULT_INSTANCES;
+  uint32_t rounds = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : DEFAULT_ROUNDS;
+
+  bench_oven_t* pOven = malloc(sizeof(bench_oven_t) * instances);
+  state_machine_t** pMachines = malloc(sizeof(state_machine_t*) * instances);
+  if((pOven == NULL) || (pMachines == NULL))
+  {
+    printf("out of memory\n");
+    return EXIT_FAILURE;
+  }
+
+  for(uint32_t index = 0; index < instances; index++)
+  {
+    pMachines[index] = &pOven[index].Machine;
+  }
+
+  const double events = (double)instances * rounds;
+  uint64_t priority = run(dispatch_event, pOven, pMachines, instances, rounds);
+  uint64_t grouped = run(dispatch_event_grouped, pOven, pMachines, instances, rounds);
+
+  printf("instances: %u, rounds: %u\n", instances, rounds);
+  printf("dispatch_event         : %10.0f events/s\n", events * 1e9 / (double)priority);
+  printf("dispatch_event_grouped : %10.0f events/s\n", events * 1e9 / (double)grouped);
+
+  free(pMachines);
+  free(pOven);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,123 @@
+/**
+ * \file
+ * \brief Handler calls saved by local transitions.
+ *
+ *  Usage: local_transition [transitions]
+ *  Moves a state machine between a composite state and its deepest substate
+ *  using traverse_state (external) and traverse_state_local (local transition).
+ *  local_transition_cached is the same benchmark with transition cache enabled.
+
+ * \author  Nandkishor Biradar
+ * \date    19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+/*
+ *  --------------------- INCLUDE FILES ---------------------
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hsm.h"
+#include "bench_util.h"
+
+/*
+ *  --------------------- DEFINITION ---------------------
+ */
+
+#define DEFAULT_TRANSITIONS   10000000u
+
+/*
+ *  --------------------- Global variables ---------------------
+ */
+
+static uint32_t Calls;    //!< Number of entry and exit actions called
+
+static state_machine_result_t action(state_machine_t* const pState)
+{
+  (void)(pState);
+  Calls++;
+  return EVENT_HANDLED;
+}
+
+static const state_t Level2_State[1];
+static const state_t Level3_State[1];
+
+static const state_t Level1_State[1] =
+{
+  {
+    .Entry  = action,
+    .Exit   = action,
+    .Node   = Level2_State,
+    .Level  = 0,
+  }
+};
+
+static const state_t Level2_State[1] =
+{
+  {
+    .Entry  = action,
+    .Exit   = action,
+    .Parent = &Level1_State[0],
+    .Node   = Level3_State,
+    .Level  = 1,
+  }
+};
+
+static const state_t Level3_State[1] =
+{
+  {
+    .Entry  = action,
+    .Exit   = action,
+    .Parent = &Level2_State[0],
+    .Level  = 2,
+  }
+};
+
+/*
+ *  --------------------- Functions ---------------------
+ */
+
+typedef state_machine_result_t (*traverse_t)(state_machine_t* const pState_Machine, const state_t* pTarget_State);
+
+static void run(const char* name, traverse_t traverse, uint32_t transitions)
+{
+  state_machine_t machine;
+  set_state(&machine, &Level1_State[0]);
+  machine.Event = 0;
+  Calls = 0;
+
+  uint64_t start = bench_now_ns();
+  for(uint32_t count = 0; count < transitions; count += 2)
+  {
+    traverse(&machine, &Level3_State[0]);   // composite state to its substate
+    traverse(&machine, &Level1_State[0]);   // substate to its composite state
+  }
+  uint64_t elapsed = bench_now_ns() - start;
+
+  printf("%-21s: %.2f actions/transition, %.1f ns/transition\n", name,
+         (double)Calls / transitions, (double)elapsed / transitions);
+
+#if HSM_TRANSITION_CACHE
+  transition_cache_stats_t stats;
+  get_transition_cache_stats(&stats);
+  printf("%-21s: %u hits, %u misses\n", "transition cache", stats.Hits, stats.Misses);
+  clear_transition_cache();
+#endif // HSM_TRANSITION_CACHE
+}
+
+int main(int argc, char* argv[])
+{
+  uint32_t transitions = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : DEFAULT_TRANSITIONS;
+
+  run("traverse_state", traverse_state, transitions);
+  run("traverse_state_local", traverse_state_local, transitions);
+  return EXIT_SUCCESS;
+}
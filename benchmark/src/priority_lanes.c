@@ -0,0 +1,196 @@
+/**
+ * \file
+ * \brief Latency of urgent events under load of periodic events.
+ *
+ *  Usage: priority_lanes [urgent_events] [tick_work]
+ *  A producer thread floods the queue of state machine with ticks, while another
+ *  thread posts urgent events with timestamp as payload. The dispatcher measures
+ *  the latency from post to handler of urgent events, when urgent events share the
+ *  lane with ticks and when they are posted in the highest priority lane.
+
+ * \author  Nandkishor Biradar
+ * \date    19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+/*
+ *  --------------------- INCLUDE FILES ---------------------
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include "hsm.h"
+#include "hsm_post.h"
+#include "bench_util.h"
+
+/*
+ *  --------------------- DEFINITION ---------------------
+ */
+
+#define DEFAULT_URGENT_EVENTS   2000u
+#define DEFAULT_TICK_WORK       200u
+#define LANE_SIZE               1024u
+#define URGENT_INTERVAL_NS      20000u
+
+#define TICK_EVENT              1u
+#define URGENT_EVENT            2u
+
+/*
+ *  --------------------- Global variables ---------------------
+ */
+
+static state_machine_t Machine;
+static event_queue_t Queue;
+static queued_event_t Cells[LANE_SIZE * HSM_QUEUE_LANES];
+
+static uint64_t Start;              //!< Reference time of payload
+static uint32_t* Latency;           //!< Latency of urgent events in nanoseconds
+static uint32_t Samples;            //!< Number of urgent events dispatched
+static uint32_t Urgent_Events;      //!< Number of urgent events to post
+static uint32_t Tick_Work;          //!< Iterations of dummy work in tick handler
+static uint32_t Stop;               //!< Stops the tick producer
+static volatile uint32_t Sink;
+
+/*
+ *  --------------------- Functions ---------------------
+ */
+
+//! Returns the time since start in nanoseconds, truncated to 32-bit.
+static inline uint32_t elapsed_ns(void)
+{
+  return (uint32_t)(bench_now_ns() - Start);
+}
+
+static state_machine_result_t handler(state_machine_t* const pState_Machine)
+{
+  if(pState_Machine->Event == URGENT_EVENT)
+  {
+    Latency[Samples++] = elapsed_ns() - get_event_payload(pState_Machine);
+  }
+  else
+  {
+    for(uint32_t count = 0; count < Tick_Work; count++)
+    {
+      Sink += count;
+    }
+  }
+  return EVENT_HANDLED;
+}
+
+static const state_t Bench_State[1] =
+{
+  {
+    .Handler = handler,
+  }
+};
+
+static void* tick_producer(void* vargp)
+{
+  (void)(vargp);
+  while(!HSM_LOAD_ACQUIRE(&Stop))
+  {
+    if(!post_event(&Machine, TICK_EVENT, NULL))
+    {
+      sched_yield();
+    }
+  }
+  return NULL;
+}
+
+static void* urgent_producer(void* vargp)
+{
+  (void)(vargp);
+  for(uint32_t count = 0; count < Urgent_Events; count++)
+  {
+    const struct timespec interval = {0, URGENT_INTERVAL_NS};
+    nanosleep(&interval, NULL);
+
+    // Timestamp of first attempt, waiting for free cell is part of latency.
+    const uint32_t timestamp = elapsed_ns();
+    while(!post_event_payload(&Machine, URGENT_EVENT, timestamp, NULL))
+    {
+      sched_yield();
+    }
+  }
+  return NULL;
+}
+
+static int compare(const void* pFirst, const void* pSecond)
+{
+  const uint32_t first = *(const uint32_t*)pFirst;
+  const uint32_t second = *(const uint32_t*)pSecond;
+  return (first > second) - (first < second);
+}
+
+//! Runs the load with urgent events posted in the given lane and prints the latency percentiles.
+static void run(const char* pName, uint32_t urgentLane)
+{
+  state_machine_t* const machines[] = {&Machine};
+  pthread_t ticks, urgent;
+
+  Machine.Event = 0;
+  Machine.State = Bench_State;
+  init_event_queue(&Machine, &Queue, Cells, LANE_SIZE);
+  set_event_lane(&Queue, TICK_EVENT, HSM_QUEUE_LANES - 1);
+  set_event_lane(&Queue, URGENT_EVENT, urgentLane);
+  Samples = 0;
+  Stop = 0;
+  Start = bench_now_ns();
+
+  pthread_create(&ticks, NULL, tick_producer, NULL);
+  pthread_create(&urgent, NULL, urgent_producer, NULL);
+
+  while(Samples < Urgent_Events)
+  {
+    dispatch_event(machines, 1);
+  }
+
+  HSM_STORE_RELEASE(&Stop, 1);
+  pthread_join(ticks, NULL);
+  pthread_join(urgent, NULL);
+
+  qsort(Latency, Urgent_Events, sizeof(Latency[0]), compare);
+  printf("%-14s %10u %10u %10u %10u\n", pName,
+         Latency[Urgent_Events / 2],
+         Latency[(Urgent_Events * 99) / 100],
+         Latency[(Urgent_Events * 999) / 1000],
+         Latency[Urgent_Events - 1]);
+}
+
+int main(int argc, char* argv[])
+{
+  Urgent_Events = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : DEFAULT_URGENT_EVENTS;
+  Tick_Work = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : DEFAULT_TICK_WORK;
+  if(Urgent_Events == 0)
+  {
+    printf("usage: priority_lanes [urgent_events] [tick_work]\n");
+    return EXIT_FAILURE;
+  }
+
+  Latency = malloc(Urgent_Events * sizeof(Latency[0]));
+  if(Latency == NULL)
+  {
+    printf("out of memory\n");
+    return EXIT_FAILURE;
+  }
+
+  printf("urgent events: %u, lanes: %u x %u cells, tick work: %u\n",
+         Urgent_Events, HSM_QUEUE_LANES, LANE_SIZE, Tick_Work);
+  printf("%-14s %10s %10s %10s %10s\n", "latency (ns)", "p50", "p99", "p99.9", "max");
+  run("same lane", HSM_QUEUE_LANES - 1);
+  run("urgent lane", 0);
+
+  free(Latency);
+  return EXIT_SUCCESS;
+}
@@ -22,9 +22,11 @@
 #include <unistd.h>
 #include <semaphore.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "hsm.h"
 #include "toaster_oven.h"
+#include "oven_event_hash.h"
 
 /*
  *  --------------------- Global variables ---------------------
@@ -75,26 +77,41 @@ void* timer(void* vargp)
 
 /** \brief Simulate the user inputs.
  *
- * It waits for the user key (ascii) input from console and pass it to parse_cli
- * to convert it into oven_event_t events. It supports start, stop, door open and door close events.
+ * It waits for the user input line from console. A single key (ascii) is passed to parse_cli
+ * and a event name (e.g. door_open) is decoded by decode_oven_event, generated by hsm_event_hash,
+ * to convert it into oven_event_t events. It supports start, stop, door open and door close events,
+ * and the timeout event by name only, that is normally generated by the oven timer.
  */
 void* console(void* vargp)
 {
   (void)(vargp);
-  while(1)
+  char input[32];
+  while(fgets(input, sizeof(input), stdin) != NULL)
   {
-    // Get input from console
-    char input  = getchar();
-
     // ignore new line input
-    if((input == '\n' ) ||(input == '\r'))
+    const size_t length = strcspn(input, "\r\n");
+    if(length == 0)
     {
       continue;
     }
 
-    parse_cli(&SampleOven, input);
+    if(length == 1)
+    {
+      parse_cli(&SampleOven, input[0]);
+    }
+    else
+    {
+      const uint32_t event = decode_oven_event(input, length);
+      if(event == 0)
+      {
+        printf("Not a valid event\n");
+        continue;
+      }
+      SampleOven.Machine.Event = event;
+    }
     sem_post(&Semaphore);
   }
+  return NULL;
 }
 
 int main(void)
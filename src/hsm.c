@@ -19,40 +19,441 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <assert.h>
 
 #include "hsm.h"
+#if HSM_EVENT_COMPLETION || HSM_EVENT_QUEUE
+#include "hsm_post.h"
+#endif // HSM_EVENT_COMPLETION || HSM_EVENT_QUEUE
 
 /*
  *  --------------------- DEFINITION ---------------------
  */
 
+//! Call the handler that is known to be non NULL.
+#define CALL_HANDLER(handler, triggerd, state_machine)          \
+do{                                                             \
+  state_machine_result_t result = handler(state_machine);       \
+  switch(result)                                                \
+  {                                                             \
+  case TRIGGERED_TO_SELF:                                       \
+    triggerd = true;                                            \
+  case EVENT_HANDLED:                                           \
+    break;                                                      \
+                                                                \
+  default:                                                      \
+    return result;                                              \
+  }                                                             \
+} while(0)
+
 #define EXECUTE_HANDLER(handler, triggerd, state_machine)       \
 do{                                                             \
   if(handler != NULL)                                           \
   {                                                             \
-    state_machine_result_t result = handler(state_machine);     \
-    switch(result)                                              \
-    {                                                           \
-    case TRIGGERED_TO_SELF:                                     \
-      triggerd = true;                                          \
-    case EVENT_HANDLED:                                         \
-      break;                                                    \
-                                                                \
-    default:                                                    \
-      return result;                                            \
-    }                                                           \
+    CALL_HANDLER(handler, triggerd, state_machine);             \
   }                                                             \
 } while(0)
 
+#if HSM_STATE_CENSUS || HSM_TRANSITION_CACHE
+#if defined(_MSC_VER)
+#define HSM_THREAD_LOCAL    __declspec(thread)
+#elif defined(__GNUC__)
+#define HSM_THREAD_LOCAL    __thread
+#else
+#define HSM_THREAD_LOCAL    _Thread_local
+#endif
+#endif // HSM_STATE_CENSUS || HSM_TRANSITION_CACHE
+
+#if HSM_STATE_CENSUS
+#define CENSUS_CACHE_LINE   64    //!< Size of cache line in bytes
+
+#if defined(_MSC_VER)
+#define CENSUS_ALIGNED      __declspec(align(CENSUS_CACHE_LINE))
+#elif defined(__GNUC__)
+#define CENSUS_ALIGNED      __attribute__((aligned(CENSUS_CACHE_LINE)))
+#else
+#define CENSUS_ALIGNED      _Alignas(CENSUS_CACHE_LINE)
+#endif
+
+//! Number of counters in a cache line
+#define CENSUS_LINE_COUNTERS  (CENSUS_CACHE_LINE / sizeof(uint32_t))
+
+//! Number of counters in a shard, rounded up to the cache line, so that shards never share a cache line.
+#define CENSUS_SHARD_SIZE   \
+  (((HSM_CENSUS_STATES + CENSUS_LINE_COUNTERS - 1) / CENSUS_LINE_COUNTERS) * CENSUS_LINE_COUNTERS)
+#endif // HSM_STATE_CENSUS
+
+/*
+ *  --------------------- GLOBAL VARIABLE ---------------------
+ */
+
+#if HSM_STATE_CENSUS
+//! Number of state machines in each state, sharded by thread. Sum of shards is the count.
+static CENSUS_ALIGNED uint32_t Census[HSM_CENSUS_SHARDS][CENSUS_SHARD_SIZE];
+static uint32_t Next_Shard;                       //!< Shard of the next thread
+static HSM_THREAD_LOCAL uint32_t Thread_Shard;    //!< Shard of the thread + 1, 0 if not assigned
+#endif // HSM_STATE_CENSUS
+
+#if HSM_STATE_INDEX
+//! List of state machines in a state
+typedef struct
+{
+  state_machine_t* Head;    //!< First state machine in the state, NULL if none
+  uint32_t Lock;            //!< Spin lock of the list
+}state_index_t;
+
+//! Lists of state machines in each state, indexed by Id of state.
+static state_index_t State_Index[HSM_INDEX_STATES];
+#endif // HSM_STATE_INDEX
+
+#if HIERARCHICAL_STATES && HSM_TRANSITION_CACHE
+//! Exit and entry sequence of a transition
+typedef struct
+{
+  const state_t* Source;                //!< Source state, NULL if entry is empty
+  const state_t* Target;                //!< Target state
+#if HSM_SUBMACHINE
+  const state_t* Source_Context;        //!< Host state of source state
+  const state_t* Target_Context;        //!< Host state of target state
+#endif // HSM_SUBMACHINE
+  bool Local;                           //!< Local transition
+  uint8_t Exits;                        //!< Number of exit actions
+  uint8_t Entries;                      //!< Number of entry actions
+  const state_t* Exit_Path[HSM_CACHE_PATH];   //!< States with exit action, from source to outermost
+  const state_t* Path[HSM_CACHE_PATH];        //!< States with entry action, from target to outermost
+}cached_transition_t;
+
+//! Transition cache of the thread. Handlers may run on any thread, so the cache needs no lock.
+static HSM_THREAD_LOCAL cached_transition_t Transition_Cache[HSM_TRANSITION_CACHE];
+static HSM_THREAD_LOCAL transition_cache_stats_t Cache_Stats;
+static uint32_t Cache_Epoch;                    //!< Incremented to clear the transition cache of all the threads
+static HSM_THREAD_LOCAL uint32_t Thread_Epoch;  //!< Epoch of the transition cache of the thread
+#endif // HIERARCHICAL_STATES && HSM_TRANSITION_CACHE
+
+/*
+ *  --------------------- Inline functions ---------------------
+ */
+
+/** \brief Save the target state in state machine during the state transition.
+ *  Unlike set_state, it doesn't publish the state to observers.
+ */
+static inline void save_state(state_machine_t* const pState_Machine, const state_t* const pState)
+{
+#if HSM_COMPACT_STATE
+  pState_Machine->State = (uint16_t)pState->Id;
+#else
+  pState_Machine->State = pState;
+#endif // HSM_COMPACT_STATE
+}
+
+#if HIERARCHICAL_STATES
+//! Returns the host state of the current shared submachine, NULL if not in a submachine.
+static inline const state_t* get_context(const state_machine_t* const pState_Machine)
+{
+#if HSM_SUBMACHINE
+  return pState_Machine->Context;
+#else
+  (void)pState_Machine;
+  return NULL;
+#endif // HSM_SUBMACHINE
+}
+
+//! Returns the host state of target state after transition. Transitions stay in the current submachine.
+static inline const state_t* get_target_context(const state_machine_t* const pState_Machine,
+                                                const state_t* const pTarget_State)
+{
+#if HSM_SUBMACHINE
+  return ((pTarget_State->Level & SUBMACHINE_FLAG) != 0) ? pState_Machine->Context : NULL;
+#else
+  (void)pState_Machine;
+  (void)pTarget_State;
+  return NULL;
+#endif // HSM_SUBMACHINE
+}
+
+//! Returns the parent of state. Parent of the top state of shared submachine is its host state.
+static inline const state_t* get_parent(const state_t* const pState, const state_t* const pContext)
+{
+#if HSM_SUBMACHINE
+  if(pState->Parent == SUBMACHINE_PARENT)
+  {
+    return pContext;
+  }
+#else
+  (void)pContext;
+#endif // HSM_SUBMACHINE
+  return pState->Parent;
+}
+
+//! Returns the hierarchy level of state. Level of state in shared submachine is relative to its host state.
+static inline uint32_t get_level(const state_t* const pState, const state_t* const pContext)
+{
+#if HSM_SUBMACHINE
+  if((pState->Level & SUBMACHINE_FLAG) != 0)
+  {
+    return (pState->Level & ~SUBMACHINE_FLAG) + pContext->Level + 1;
+  }
+#else
+  (void)pContext;
+#endif // HSM_SUBMACHINE
+  return pState->Level;
+}
+
+//! Returns true if both are the same state. A state of shared submachine is same only in the same host state.
+static inline bool is_same_state(const state_t* const pFirst, const state_t* const pFirst_Context,
+                                 const state_t* const pSecond, const state_t* const pSecond_Context)
+{
+#if HSM_SUBMACHINE
+  if((pFirst == pSecond) && (pFirst != NULL) && ((pFirst->Level & SUBMACHINE_FLAG) != 0))
+  {
+    return pFirst_Context == pSecond_Context;
+  }
+#else
+  (void)pFirst_Context;
+  (void)pSecond_Context;
+#endif // HSM_SUBMACHINE
+  return pFirst == pSecond;
+}
+#endif // HIERARCHICAL_STATES
+
+#if HSM_STATE_CENSUS
+//! Returns the census shard of calling thread. Threads are assigned to shards round robin.
+static inline uint32_t* get_census_shard(void)
+{
+  if(Thread_Shard == 0)
+  {
+    Thread_Shard = (HSM_FETCH_ADD(&Next_Shard, 1) % HSM_CENSUS_SHARDS) + 1;
+  }
+  return Census[Thread_Shard - 1];
+}
+#endif // HSM_STATE_CENSUS
+
+#if HSM_STATE_INDEX
+static inline void lock_index(state_index_t* const pIndex)
+{
+  uint32_t unlocked = 0;
+  while(!HSM_COMPARE_EXCHANGE(&pIndex->Lock, &unlocked, 1))
+  {
+    unlocked = 0;
+  }
+}
+
+static inline void unlock_index(state_index_t* const pIndex)
+{
+  HSM_STORE_RELEASE(&pIndex->Lock, 0);
+}
+
+//! Insert the state machine at the head of list of state.
+static inline void link_machine(state_machine_t* const pState_Machine, const state_t* const pState)
+{
+  assert(pState->Id < HSM_INDEX_STATES);
+  state_index_t* const pIndex = &State_Index[pState->Id];
+  lock_index(pIndex);
+  pState_Machine->Index_Prev = NULL;
+  pState_Machine->Index_Next = pIndex->Head;
+  if(pIndex->Head != NULL)
+  {
+    pIndex->Head->Index_Prev = pState_Machine;
+  }
+  pIndex->Head = pState_Machine;
+  unlock_index(pIndex);
+}
+
+//! Remove the state machine from the list of state.
+static inline void unlink_machine(state_machine_t* const pState_Machine, const state_t* const pState)
+{
+  assert(pState->Id < HSM_INDEX_STATES);
+  state_index_t* const pIndex = &State_Index[pState->Id];
+  lock_index(pIndex);
+  if(pState_Machine->Index_Prev != NULL)
+  {
+    pState_Machine->Index_Prev->Index_Next = pState_Machine->Index_Next;
+  }
+  else
+  {
+    pIndex->Head = pState_Machine->Index_Next;
+  }
+  if(pState_Machine->Index_Next != NULL)
+  {
+    pState_Machine->Index_Next->Index_Prev = pState_Machine->Index_Prev;
+  }
+  unlock_index(pIndex);
+}
+#endif // HSM_STATE_INDEX
+
+/** \brief Move the state machine from source to target state in the census and index.
+ *  It is a no-op if both are disabled.
+ */
+static inline void track_transition(state_machine_t* const pState_Machine,
+                                    const state_t* const pSource_State,
+                                    const state_t* const pTarget_State)
+{
+  (void)pState_Machine;
+#if HSM_STATE_CENSUS || HSM_STATE_INDEX
+  if(pSource_State != pTarget_State)
+  {
+#if HSM_STATE_CENSUS
+    assert((pSource_State->Id < HSM_CENSUS_STATES) && (pTarget_State->Id < HSM_CENSUS_STATES));
+    uint32_t* const pShard = get_census_shard();
+    HSM_FETCH_ADD(&pShard[pSource_State->Id], (uint32_t)-1);
+    HSM_FETCH_ADD(&pShard[pTarget_State->Id], 1);
+#endif // HSM_STATE_CENSUS
+#if HSM_STATE_INDEX
+    unlink_machine(pState_Machine, pSource_State);
+    link_machine(pState_Machine, pTarget_State);
+#endif // HSM_STATE_INDEX
+  }
+#else
+  (void)pSource_State;
+  (void)pTarget_State;
+#endif // HSM_STATE_CENSUS || HSM_STATE_INDEX
+}
+
+/** \brief Check if the state machine has pending event.
+ *  If the state machine has event queue, the next event is fetched from it.
+ */
+static inline bool has_event(state_machine_t* const pState_Machine)
+{
+#if HSM_EVENT_QUEUE
+  if((pState_Machine->Event == 0) && (pState_Machine->Queue != NULL))
+  {
+    return fetch_event(pState_Machine);
+  }
+#endif // HSM_EVENT_QUEUE
+  return pState_Machine->Event != 0;
+}
+
+/** \brief Complete the run to completion step of state machine.
+ *  Publishes the new state to observers and resolves the completion token of event.
+ *
+ * \param pState_Machine state_machine_t* const   pointer to state machine
+ * \param result state_machine_result_t           result of run to completion step
+ * \return state_machine_result_t                 same as result
+ *
+ */
+static inline state_machine_result_t complete_step(state_machine_t* const pState_Machine,
+                                                   state_machine_result_t result)
+{
+#if HSM_PUBLISH_STATE
+  if((result == EVENT_HANDLED) || (result == TRIGGERED_TO_SELF))
+  {
+    HSM_STORE_RELEASE(&pState_Machine->Published, pState_Machine->State);
+  }
+#endif // HSM_PUBLISH_STATE
+
+#if HSM_EVENT_COMPLETION
+  event_token_t* const pToken = HSM_LOAD_ACQUIRE(&pState_Machine->Token);
+  if(pToken != NULL)
+  {
+    // Release the token slot for producers only when the Event is cleared.
+    // Event triggered to self or not handled, keeps the slot busy.
+    HSM_STORE_RELEASE(&pState_Machine->Token,
+                      (result == EVENT_HANDLED) ? NULL : &Anonymous_Token);
+    resolve_event_token(pToken, result);
+  }
+#endif // HSM_EVENT_COMPLETION
+
+#if !HSM_PUBLISH_STATE && !HSM_EVENT_COMPLETION
+  (void)pState_Machine;
+#endif
+  return result;
+}
+
+/*
+ *  --------------------- Function prototype ---------------------
+ */
+
+static state_machine_result_t dispatch_to_machine(state_machine_t* const pState_Machine
+                                                  ,uint32_t* const pInvocations
+#if STATE_MACHINE_LOGGER
+                                                  ,uint32_t index
+                                                  ,state_machine_event_logger event_logger
+                                                  ,state_machine_result_logger result_logger
+#endif // STATE_MACHINE_LOGGER
+                                                  );
+
 /*
  *  --------------------- FUNCTION BODY ---------------------
  */
 
+/** \brief Dispatch the pending event of a state machine to its current state.
+ *  If the state handler couldn't handle the event then it dispatches the event to its parent states.
+ *
+ * \param pState_Machine state_machine_t* const   pointer to state machine
+ * \param pInvocations uint32_t* const            incremented for each handler invoked
+ * \return state_machine_result_t                 EVENT_HANDLED, TRIGGERED_TO_SELF or error
+ *
+ */
+static state_machine_result_t dispatch_to_machine(state_machine_t* const pState_Machine
+                                                  ,uint32_t* const pInvocations
+#if STATE_MACHINE_LOGGER
+                                                  ,uint32_t index
+                                                  ,state_machine_event_logger event_logger
+                                                  ,state_machine_result_logger result_logger
+#endif // STATE_MACHINE_LOGGER
+                                                  )
+{
+  state_machine_result_t result;
+  const state_t* pState = get_state(pState_Machine);
+  do
+  {
+    (*pInvocations)++;
+#if STATE_MACHINE_LOGGER
+    event_logger(index, pState->Id, pState_Machine->Event);
+#endif // STATE_MACHINE_LOGGER
+      // Call the state handler.
+    result = pState->Handler(pState_Machine);
+#if STATE_MACHINE_LOGGER
+    result_logger(get_state(pState_Machine)->Id, result);
+#endif // STATE_MACHINE_LOGGER
+
+    switch(result)
+    {
+    case EVENT_HANDLED:
+      // Clear event, if successfully handled by state handler.
+      pState_Machine->Event = 0;
+
+      // intentional fall through
+
+      // State handler handled the previous event successfully,
+      // and posted a new event to itself.
+    case TRIGGERED_TO_SELF:
+      return complete_step(pState_Machine, result);
+
+  #if HIERARCHICAL_STATES
+  // State handler could not handled the event.
+  // Traverse to its parent state and dispatch event to parent state handler.
+    case EVENT_UN_HANDLED:
+
+      do
+      {
+        const state_t* const pParent = get_parent(pState, get_context(pState_Machine));
+        // check if state has parent state.
+        if(pParent == NULL)   // Is Node reached top
+        {
+          // This is a fatal error. terminate state machine.
+          return complete_step(pState_Machine, EVENT_UN_HANDLED);
+        }
+
+        pState = pParent;        // traverse to parent state
+      }while(pState->Handler == NULL);   // repeat again if parent state doesn't have handler
+      continue;
+  #endif // HIERARCHICAL_STATES
+
+    // Either state handler could not handle the event or it has returned
+    // the unknown return code. Terminate the state machine.
+    default:
+      return complete_step(pState_Machine, result);
+    }
+  }while(1);
+}
+
 /** \brief dispatch events to state machine
  *
  * \param pState_Machine[] state_machine_t* const  array of state machines
  * \param quantity uint32_t number of state machines
- * \return state_machine_result_t result of state machine
+ * \return state_machine_result_t result of state machine.
+ *         BUDGET_EXHAUSTED if more than HSM_DISPATCH_BUDGET handlers are invoked.
  *
  */
 state_machine_result_t dispatch_event(state_machine_t* const pState_Machine[]
@@ -62,73 +463,282 @@ state_machine_result_t dispatch_event(state_machine_t* const pState_Machine[]
                                       ,state_machine_result_logger result_logger
 #endif // STATE_MACHINE_LOGGER
                                       )
+{
+  return dispatch_event_budget(pState_Machine, quantity, HSM_DISPATCH_BUDGET
+#if STATE_MACHINE_LOGGER
+                               ,event_logger, result_logger
+#endif // STATE_MACHINE_LOGGER
+                               );
+}
+
+/** \brief dispatch events to state machine with a handler budget chosen by the caller.
+ *  Same as dispatch_event, but the budget is passed per call instead of HSM_DISPATCH_BUDGET.
+ *  Use it to give a different budget to each dispatcher thread or to each call.
+ *
+ * \param pState_Machine[] state_machine_t* const  array of state machines
+ * \param quantity uint32_t number of state machines
+ * \param budget uint32_t maximum number of handler invocations in this call, 0: no limit.
+ * \return state_machine_result_t result of state machine.
+ *         BUDGET_EXHAUSTED if more than budget handlers are invoked.
+ *
+ */
+state_machine_result_t dispatch_event_budget(state_machine_t* const pState_Machine[]
+                                             ,uint32_t quantity
+                                             ,uint32_t budget
+#if STATE_MACHINE_LOGGER
+                                             ,state_machine_event_logger event_logger
+                                             ,state_machine_result_logger result_logger
+#endif // STATE_MACHINE_LOGGER
+                                             )
 {
   state_machine_result_t result;
+  uint32_t invocations = 0;   // Number of handlers invoked in this call
 
   // Iterate through all state machines in the array to check if event is pending to dispatch.
   for(uint32_t index = 0; index < quantity;)
   {
-    if(pState_Machine[index]->Event == 0)
+    if(!has_event(pState_Machine[index]))
+    {
+      index++;
+      continue;
+    }
+
+    // Stop before dispatching a new event, if budget is exhausted.
+    // The event is left pending and it is dispatched in the next call.
+    if((budget != 0) && (invocations >= budget))
+    {
+      return BUDGET_EXHAUSTED;
+    }
+
+    result = dispatch_to_machine(pState_Machine[index], &invocations
+#if STATE_MACHINE_LOGGER
+                                 ,index, event_logger, result_logger
+#endif // STATE_MACHINE_LOGGER
+                                 );
+    switch(result)
+    {
+    case EVENT_HANDLED:
+    case TRIGGERED_TO_SELF:
+      index = 0;  // Restart the event dispatcher from the first state machine.
+      break;
+
+    default:
+      return result;
+    }
+  }
+  return EVENT_HANDLED;
+}
+
+/** \brief dispatch events to state machines until a limit on the number of events or time is reached.
+ *  The limits are checked before dispatching each event, hence an event is never interrupted in
+ *  the middle of run to completion step. Use it to interleave the state machines with other
+ *  latency sensitive work in the same thread.
+ *
+ * \param pState_Machine[] state_machine_t* const  array of state machines
+ * \param quantity uint32_t number of state machines
+ * \param maxEvents uint32_t maximum number of run to completion steps, 0: no limit.
+ * \param get_time dispatch_clock function returning the current time, NULL: no deadline.
+ * \param deadline uint32_t time returned by get_time to stop dispatching. Wrap around of time is handled.
+ * \return state_machine_result_t result of state machine.
+ *         BUDGET_EXHAUSTED if a limit is reached and events are still pending.
+ *
+ */
+state_machine_result_t dispatch_event_bounded(state_machine_t* const pState_Machine[]
+                                              ,uint32_t quantity
+                                              ,uint32_t maxEvents
+                                              ,dispatch_clock get_time
+                                              ,uint32_t deadline
+#if STATE_MACHINE_LOGGER
+                                              ,state_machine_event_logger event_logger
+                                              ,state_machine_result_logger result_logger
+#endif // STATE_MACHINE_LOGGER
+                                              )
+{
+  state_machine_result_t result;
+  uint32_t invocations = 0;   // Number of handlers invoked in this call
+  uint32_t events = 0;        // Number of run to completion steps in this call
+
+  for(uint32_t index = 0; index < quantity;)
+  {
+    if(!has_event(pState_Machine[index]))
     {
       index++;
       continue;
     }
 
-    const state_t* pState = pState_Machine[index]->State;
-    do
+    // Stop before dispatching a new event, if any limit is reached.
+    if(((maxEvents != 0) && (events >= maxEvents))
+       || ((get_time != NULL) && ((int32_t)(get_time() - deadline) >= 0)))
+    {
+      return BUDGET_EXHAUSTED;
+    }
+#if HSM_DISPATCH_BUDGET
+    if(invocations >= HSM_DISPATCH_BUDGET)
     {
+      return BUDGET_EXHAUSTED;
+    }
+#endif // HSM_DISPATCH_BUDGET
+
+    events++;
+    result = dispatch_to_machine(pState_Machine[index], &invocations
 #if STATE_MACHINE_LOGGER
-      event_logger(index, pState->Id, pState_Machine[index]->Event);
+                                 ,index, event_logger, result_logger
 #endif // STATE_MACHINE_LOGGER
-        // Call the state handler.
-      result = pState->Handler(pState_Machine[index]);
+                                 );
+    switch(result)
+    {
+    case EVENT_HANDLED:
+    case TRIGGERED_TO_SELF:
+      index = 0;  // Restart the event dispatcher from the first state machine.
+      break;
+
+    default:
+      return result;
+    }
+  }
+  return EVENT_HANDLED;
+}
+
+/** \brief Bucket of the group of state machine in dispatch_event_grouped.
+ *  State machines having the same state and the same pending event fall in the same bucket.
+ */
+static inline uint32_t group_bucket(const state_machine_t* const pState_Machine)
+{
+  const uint32_t key = (uint32_t)((uintptr_t)get_state(pState_Machine) / sizeof(state_t))
+                     + (pState_Machine->Event * 0x9E3779B9u);
+  return ((key * 0x85EBCA6Bu) >> 16) & (HSM_GROUPED_BUCKETS - 1);
+}
+
+/** \brief dispatch events to state machines grouped by their current state and event.
+ *
+ *  The state machines having the same state and same pending event are dispatched back to back,
+ *  so that a state handler runs over its whole group before the next handler is called.
+ *  Each pass sorts HSM_GROUPED_BATCH state machines at a time into buckets by state and event,
+ *  using counting sort, hence the cost of a pass is linear in the number of state machines.
+ *  It doesn't follow the priority of state machines. Use it for large number of state machines
+ *  sharing the same state tables.
+ *
+ * \param pState_Machine[] state_machine_t* const  array of state machines
+ * \param quantity uint32_t number of state machines
+ * \return state_machine_result_t result of state machine.
+ *         BUDGET_EXHAUSTED if more than HSM_DISPATCH_BUDGET handlers are invoked.
+ *
+ */
+state_machine_result_t dispatch_event_grouped(state_machine_t* const pState_Machine[]
+                                              ,uint32_t quantity
 #if STATE_MACHINE_LOGGER
-      result_logger(pState_Machine[index]->State->Id, result);
+                                              ,state_machine_event_logger event_logger
+                                              ,state_machine_result_logger result_logger
 #endif // STATE_MACHINE_LOGGER
+                                              )
+{
+  state_machine_result_t result;
+  uint32_t invocations = 0;   // Number of handlers invoked in this call
+  bool dispatched;
+
+  uint16_t bucket[HSM_GROUPED_BATCH];           // Bucket of each state machine of the batch
+  uint16_t order[HSM_GROUPED_BATCH];            // Pending state machines of the batch, sorted by bucket
+  uint16_t first[HSM_GROUPED_BUCKETS + 1];      // Start of each bucket in the order
+  uint16_t last[HSM_GROUPED_BUCKETS];           // End of remaining members of each bucket
+
+  // Repeat until a pass over all the state machines finds no pending event.
+  do
+  {
+    dispatched = false;
+    for(uint32_t base = 0; base < quantity; base += HSM_GROUPED_BATCH)
+    {
+      const uint32_t batch = ((quantity - base) < HSM_GROUPED_BATCH) ? (quantity - base) : HSM_GROUPED_BATCH;
+      state_machine_t* const* const pBatch = &pState_Machine[base];
 
-      switch(result)
+      // Count the pending state machines in each bucket. has_event fetches the queued event.
+      for(uint32_t index = 0; index <= HSM_GROUPED_BUCKETS; index++)
+      {
+        first[index] = 0;
+      }
+      for(uint32_t index = 0; index < batch; index++)
       {
-      case EVENT_HANDLED:
-        // Clear event, if successfully handled by state handler.
-        pState_Machine[index]->Event = 0;
+        if(has_event(pBatch[index]))
+        {
+          bucket[index] = (uint16_t)group_bucket(pBatch[index]);
+          first[bucket[index] + 1]++;
+        }
+        else
+        {
+          bucket[index] = HSM_GROUPED_BUCKETS;
+        }
+      }
 
-        // intentional fall through
+      for(uint32_t index = 1; index <= HSM_GROUPED_BUCKETS; index++)
+      {
+        first[index] = (uint16_t)(first[index] + first[index - 1]);
+      }
+      for(uint32_t index = 0; index < batch; index++)
+      {
+        if(bucket[index] != HSM_GROUPED_BUCKETS)
+        {
+          order[first[bucket[index]]++] = (uint16_t)index;
+        }
+      }
 
-        // State handler handled the previous event successfully,
-        // and posted a new event to itself.
-      case TRIGGERED_TO_SELF:
+      // After the placement, first[n] is the end of bucket n and the start of bucket n + 1.
+      for(uint32_t index = 0; index < HSM_GROUPED_BUCKETS; index++)
+      {
+        last[index] = first[index];
+      }
 
-        index = 0;  // Restart the event dispatcher from the first state machine.
-        break;
+      // Groups are dispatched in the order of their first state machine.
+      for(uint32_t index = 0; index < batch; index++)
+      {
+        const uint32_t group = bucket[index];
+        if(group == HSM_GROUPED_BUCKETS)
+        {
+          continue;   // No pending event or already dispatched.
+        }
 
-    #if HIERARCHICAL_STATES
-    // State handler could not handled the event.
-    // Traverse to its parent state and dispatch event to parent state handler.
-      case EVENT_UN_HANDLED:
+        // Bucket may have more than one group. Dispatch the members of this group and
+        // keep the remaining members in the bucket.
+        const state_t* const pState = get_state(pBatch[index]);
+        const uint32_t event = pBatch[index]->Event;
+        uint32_t remaining = (group == 0) ? 0 : first[group - 1];
 
-        do
+        for(uint32_t member = remaining; member < last[group]; member++)
         {
-          // check if state has parent state.
-          if(pState->Parent == NULL)   // Is Node reached top
+          state_machine_t* const pMember = pBatch[order[member]];
+          if((pMember->Event != event) || (get_state(pMember) != pState))
           {
-            // This is a fatal error. terminate state machine.
-            return EVENT_UN_HANDLED;
+            order[remaining++] = order[member];
+            continue;
           }
+          bucket[order[member]] = HSM_GROUPED_BUCKETS;
 
-          pState = pState->Parent;        // traverse to parent state
-        }while(pState->Handler == NULL);   // repeat again if parent state doesn't have handler
-        continue;
-    #endif // HIERARCHICAL_STATES
+#if HSM_DISPATCH_BUDGET
+          if(invocations >= HSM_DISPATCH_BUDGET)
+          {
+            return BUDGET_EXHAUSTED;
+          }
+#endif // HSM_DISPATCH_BUDGET
 
-      // Either state handler could not handle the event or it has returned
-      // the unknown return code. Terminate the state machine.
-      default:
-        return result;
+          result = dispatch_to_machine(pMember, &invocations
+#if STATE_MACHINE_LOGGER
+                                       ,base + order[member], event_logger, result_logger
+#endif // STATE_MACHINE_LOGGER
+                                       );
+          switch(result)
+          {
+          case EVENT_HANDLED:
+          case TRIGGERED_TO_SELF:
+            dispatched = true;
+            break;
+
+          default:
+            return result;
+          }
+        }
+        last[group] = (uint16_t)remaining;
       }
-      break;
+    }
+  }while(dispatched);
 
-    }while(1);
-  }
   return EVENT_HANDLED;
 }
 
@@ -142,9 +752,13 @@ state_machine_result_t dispatch_event(state_machine_t* const pState_Machine[]
 extern state_machine_result_t switch_state(state_machine_t* const pState_Machine,
                                            const state_t* const pTarget_State)
 {
-  const state_t* const pSource_State = pState_Machine->State;
+  const state_t* const pSource_State = get_state(pState_Machine);
   bool triggered_to_self = false;
-  pState_Machine->State = pTarget_State;    // Save the target node
+  save_state(pState_Machine, pTarget_State);    // Save the target node
+#if HSM_SUBMACHINE
+  pState_Machine->Context = get_target_context(pState_Machine, pTarget_State);
+#endif // HSM_SUBMACHINE
+  track_transition(pState_Machine, pSource_State, pTarget_State);
 
   // Call Exit function before leaving the Source state.
     EXECUTE_HANDLER(pSource_State->Exit, triggered_to_self, pState_Machine);
@@ -160,23 +774,249 @@ extern state_machine_result_t switch_state(state_machine_t* const pState_Machine
 }
 
 #if HIERARCHICAL_STATES
+/** \brief Compute the exit and entry sequence of transition without calling any handler.
+ *  States without exit (or entry) action are skipped, so that only the actions are stored.
+ *
+ * \param pSource_State const state_t*   source state
+ * \param pSource_Context const state_t* host state of source state, if it is in shared submachine
+ * \param pTarget_State const state_t*   target state
+ * \param pTarget_Context const state_t* host state of target state, if it is in shared submachine
+ * \param local bool                     true: local transition
+ * \param pExit_Path[] const state_t*    array to store the states to exit, from source to outermost.
+ *                                       Size must be at least Level of source + 1.
+ * \param pExits uint32_t* const         number of states to exit
+ * \param pPath[] const state_t*         array to store the states to enter, from target to outermost.
+ *                                       Size must be at least Level of target + 1.
+ * \return uint32_t                      number of states to enter
+ *
+ */
+static inline uint32_t plan_traverse(const state_t* pSource_State,
+                                     const state_t* const pSource_Context,
+                                     const state_t* pTarget_State,
+                                     const state_t* const pTarget_Context,
+                                     bool local,
+                                     const state_t* pExit_Path[],
+                                     uint32_t* const pExits,
+                                     const state_t* pPath[])
+{
+  uint32_t exits = 0;
+  uint32_t index = 0;
+
+  // make the source state & target state at the same hierarchy level.
+
+  // Is source hierarchy level is less than target hierarchy level?
+  if(get_level(pSource_State, pSource_Context) > get_level(pTarget_State, pTarget_Context))
+  {
+    // Traverse the source state to upward,
+    // till it matches with target state hierarchy level.
+    while(get_level(pSource_State, pSource_Context) > get_level(pTarget_State, pTarget_Context))
+    {
+      if(pSource_State->Exit != NULL)
+      {
+        pExit_Path[exits++] = pSource_State;
+      }
+      pSource_State = get_parent(pSource_State, pSource_Context);
+    }
+  }
+  // Is Source hierarchy level greater than target level?
+  else if(get_level(pSource_State, pSource_Context) < get_level(pTarget_State, pTarget_Context))
+  {
+    // Traverse the target state to upward,
+    // Till it matches with source state hierarchy level.
+    while(get_level(pSource_State, pSource_Context) < get_level(pTarget_State, pTarget_Context))
+    {
+      if(pTarget_State->Entry != NULL)
+      {
+        pPath[index++] = pTarget_State;  // Store the target node path.
+      }
+      pTarget_State = get_parent(pTarget_State, pTarget_Context);
+    }
+  }
+
+  // Now Source & Target are at same hierarchy level.
+  // In local transition, if one of them is ancestor of other, then it is the least common ancestor.
+  // Don't exit and re-enter it.
+  if((local == false) || !is_same_state(pSource_State, pSource_Context, pTarget_State, pTarget_Context))
+  {
+    // Traverse the source & target state to upward, till we find their common parent.
+    while(!is_same_state(get_parent(pSource_State, pSource_Context), pSource_Context,
+                        get_parent(pTarget_State, pTarget_Context), pTarget_Context))
+    {
+      if(pSource_State->Exit != NULL)
+      {
+        pExit_Path[exits++] = pSource_State;
+      }
+      pSource_State = get_parent(pSource_State, pSource_Context);  // Move source state to upward state.
+
+      if(pTarget_State->Entry != NULL)
+      {
+        pPath[index++] = pTarget_State;       // Store the target node path.
+      }
+      pTarget_State = get_parent(pTarget_State, pTarget_Context);  // Move the target state to upward state.
+    }
+
+    // Exit the source state and enter the target state below the common parent.
+    if(pSource_State->Exit != NULL)
+    {
+      pExit_Path[exits++] = pSource_State;
+    }
+    if(pTarget_State->Entry != NULL)
+    {
+      pPath[index++] = pTarget_State;
+    }
+  }
+
+  *pExits = exits;
+  return index;
+}
+
+/** \brief Call the exit and entry actions of transition computed by plan_traverse.
+ *
+ * \param pState_Machine state_machine_t* const   pointer to state machine
+ * \param pExit_Path[] const state_t* const       states to exit, from source to outermost
+ * \param exits uint32_t                          number of states to exit
+ * \param pPath[] const state_t* const            states to enter, from target to outermost
+ * \param entries uint32_t                        number of states to enter
+ * \return state_machine_result_t                 Result of state traversal
+ *
+ */
+static inline state_machine_result_t run_traverse(state_machine_t* const pState_Machine,
+                                                  const state_t* const pExit_Path[],
+                                                  uint32_t exits,
+                                                  const state_t* const pPath[],
+                                                  uint32_t entries)
+{
+  bool triggered_to_self = false;
+
+  // Call Exit function before leaving the Source state and its ancestors.
+  for(uint32_t index = 0; index < exits; index++)
+  {
+    CALL_HANDLER(pExit_Path[index]->Exit, triggered_to_self, pState_Machine);
+  }
+
+  // Now traverse down to the target node & call their entry functions.
+  while(entries)
+  {
+    entries--;
+    CALL_HANDLER(pPath[entries]->Entry, triggered_to_self, pState_Machine);
+  }
+
+  if(triggered_to_self == true)
+  {
+    return TRIGGERED_TO_SELF;
+  }
+  return EVENT_HANDLED;
+}
+
+#if HSM_TRANSITION_CACHE
+//! Returns the home entry of transition in the cache.
+static inline uint32_t hash_transition(const state_t* const pSource_State,
+                                       const state_t* const pTarget_State,
+                                       const state_t* const pTarget_Context,
+                                       bool local)
+{
+  const uint32_t key = (uint32_t)(((uintptr_t)pSource_State >> 3) * 31u)
+                       ^ (uint32_t)((uintptr_t)pTarget_State >> 3)
+                       ^ (uint32_t)((uintptr_t)pTarget_Context >> 3)
+                       ^ (uint32_t)local;
+  return ((key * 0x9E3779B1u) >> 16) & (HSM_TRANSITION_CACHE - 1);
+}
+
+/** \brief Find the transition in the cache of calling thread.
+ *
+ * \return cached_transition_t*  cached transition, or the entry to store the transition if it is not found.
+ *         pFound is false if not found.
+ *
+ */
+static inline cached_transition_t* find_transition(const state_t* const pSource_State,
+                                                   const state_t* const pSource_Context,
+                                                   const state_t* const pTarget_State,
+                                                   const state_t* const pTarget_Context,
+                                                   bool local,
+                                                   bool* const pFound)
+{
+  const uint32_t epoch = HSM_LOAD_ACQUIRE(&Cache_Epoch);
+  if(epoch != Thread_Epoch)
+  {
+    // Cache is cleared by clear_transition_cache, possibly on other thread.
+    for(uint32_t index = 0; index < HSM_TRANSITION_CACHE; index++)
+    {
+      Transition_Cache[index].Source = NULL;
+    }
+    Thread_Epoch = epoch;
+  }
+
+  const uint32_t home = hash_transition(pSource_State, pTarget_State, pTarget_Context, local);
+#if !HSM_SUBMACHINE
+  (void)pSource_Context;
+#endif // !HSM_SUBMACHINE
+
+  for(uint32_t probe = 0; probe < HSM_CACHE_PROBES; probe++)
+  {
+    cached_transition_t* const pEntry = &Transition_Cache[(home + probe) & (HSM_TRANSITION_CACHE - 1)];
+    if(pEntry->Source == NULL)
+    {
+      *pFound = false;
+      return pEntry;
+    }
+    if((pEntry->Source == pSource_State) && (pEntry->Target == pTarget_State) && (pEntry->Local == local)
+#if HSM_SUBMACHINE
+       && (pEntry->Source_Context == pSource_Context) && (pEntry->Target_Context == pTarget_Context)
+#endif // HSM_SUBMACHINE
+      )
+    {
+      *pFound = true;
+      return pEntry;
+    }
+  }
+
+  // Probed entries are full, replace the home entry.
+  *pFound = false;
+  return &Transition_Cache[home];
+}
+#endif // HSM_TRANSITION_CACHE
+
 /** \brief Traverse to target state. It calls exit functions before leaving
       the source state & calls entry function before entering the target state.
  *
  * \param pState_Machine state_machine_t* const   pointer to state machine
  * \param pTarget_State const state_t*            Target state to traverse
+ * \param local bool                              true: Don't exit and re-enter the source (or target) state,
+ *                                                if target (or source) is its substate.
+ * \param pTarget_Context const state_t* const    host state of target state, if it is in shared submachine
  * \return state_machine_result_t                 Result of state traversal
  *
  */
-state_machine_result_t traverse_state(state_machine_t* const pState_Machine,
-                                              const state_t* pTarget_State)
+static state_machine_result_t traverse(state_machine_t* const pState_Machine,
+                                       const state_t* pTarget_State,
+                                       bool local,
+                                       const state_t* const pTarget_Context)
 {
-  const state_t *pSource_State = pState_Machine->State;
-  bool triggered_to_self = false;
-  pState_Machine->State = pTarget_State;    // Save the target node
+  const state_t* const pSource_State = get_state(pState_Machine);
+  const state_t* const pSource_Context = get_context(pState_Machine);
+  save_state(pState_Machine, pTarget_State);    // Save the target node
+#if HSM_SUBMACHINE
+  pState_Machine->Context = pTarget_Context;
+#endif // HSM_SUBMACHINE
+  track_transition(pState_Machine, pSource_State, pTarget_State);
+
+#if HSM_TRANSITION_CACHE
+  bool found;
+  cached_transition_t* const pEntry = find_transition(pSource_State, pSource_Context,
+                                                      pTarget_State, pTarget_Context, local, &found);
+  if(found)
+  {
+    Cache_Stats.Hits++;
+    // Copy the path, as a nested transition in an action may replace the entry.
+    const cached_transition_t cached = *pEntry;
+    return run_traverse(pState_Machine, cached.Exit_Path, cached.Exits, cached.Path, cached.Entries);
+  }
+  Cache_Stats.Misses++;
+#endif // HSM_TRANSITION_CACHE
 
 #if (HSM_USE_VARIABLE_LENGTH_ARRAY == 1)
-  const state_t *pTarget_Path[pTarget_State->Level];  // Array to store the target node path
+  const state_t *pSource_Path[get_level(pSource_State, pSource_Context) + 1];  // Array to store the source node path
+  const state_t *pTarget_Path[get_level(pTarget_State, pTarget_Context) + 1];  // Array to store the target node path
 #else
   #if  (!defined(MAX_HIERARCHICAL_LEVEL) || (MAX_HIERARCHICAL_LEVEL == 0))
   #error "MAX_HIERARCHICAL_LEVEL is undefined."\
@@ -184,64 +1024,256 @@ state_machine_result_t traverse_state(state_machine_t* const pState_Machine,
           use variable length array by setting HSM_USE_VARIABLE_LENGTH_ARRAY to 1"
   #endif
 
-  const state_t* pTarget_Path[MAX_HIERARCHICAL_LEVEL];     // Array to store the target node path
+  const state_t* pSource_Path[MAX_HIERARCHICAL_LEVEL + 1];     // Array to store the source node path
+  const state_t* pTarget_Path[MAX_HIERARCHICAL_LEVEL + 1];     // Array to store the target node path
 #endif
 
-  uint32_t index = 0;
+  uint32_t exits;
+  const uint32_t entries = plan_traverse(pSource_State, pSource_Context, pTarget_State, pTarget_Context,
+                                         local, pSource_Path, &exits, pTarget_Path);
 
-  // make the source state & target state at the same hierarchy level.
-
-  // Is source hierarchy level is less than target hierarchy level?
-  if(pSource_State->Level > pTarget_State->Level)
+#if HSM_TRANSITION_CACHE
+  if((entries <= HSM_CACHE_PATH) && (exits <= HSM_CACHE_PATH))
   {
-    // Traverse the source state to upward,
-    // till it matches with target state hierarchy level.
-    while(pSource_State->Level > pTarget_State->Level)
+    pEntry->Source = pSource_State;
+    pEntry->Target = pTarget_State;
+#if HSM_SUBMACHINE
+    pEntry->Source_Context = pSource_Context;
+    pEntry->Target_Context = pTarget_Context;
+#endif // HSM_SUBMACHINE
+    pEntry->Local = local;
+    pEntry->Exits = (uint8_t)exits;
+    pEntry->Entries = (uint8_t)entries;
+    for(uint32_t index = 0; index < exits; index++)
+    {
+      pEntry->Exit_Path[index] = pSource_Path[index];
+    }
+    for(uint32_t index = 0; index < entries; index++)
     {
-      EXECUTE_HANDLER(pSource_State->Exit, triggered_to_self, pState_Machine);
-      pSource_State = pSource_State->Parent;
+      pEntry->Path[index] = pTarget_Path[index];
     }
   }
-  // Is Source hierarchy level greater than target level?
-  else if(pSource_State->Level < pTarget_State->Level)
+#endif // HSM_TRANSITION_CACHE
+
+  return run_traverse(pState_Machine, pSource_Path, exits, pTarget_Path, entries);
+}
+
+/** \brief Traverse to target state. It calls exit functions before leaving
+      the source state & calls entry function before entering the target state.
+      If the target is substate or ancestor of the source state, then it exits and re-enters
+      the ancestor state (external transition).
+ *
+ * \param pState_Machine state_machine_t* const   pointer to state machine
+ * \param pTarget_State const state_t*            Target state to traverse
+ * \return state_machine_result_t                 Result of state traversal
+ *
+ */
+state_machine_result_t traverse_state(state_machine_t* const pState_Machine,
+                                              const state_t* pTarget_State)
+{
+  return traverse(pState_Machine, pTarget_State, false, get_target_context(pState_Machine, pTarget_State));
+}
+
+/** \brief Traverse to target state using local transition. Same as traverse_state,
+      but if the target is substate or ancestor of the source state, then it doesn't exit and re-enter
+      the ancestor state.
+ *
+ * \param pState_Machine state_machine_t* const   pointer to state machine
+ * \param pTarget_State const state_t*            Target state to traverse
+ * \return state_machine_result_t                 Result of state traversal
+ *
+ */
+state_machine_result_t traverse_state_local(state_machine_t* const pState_Machine,
+                                            const state_t* pTarget_State)
+{
+  return traverse(pState_Machine, pTarget_State, true, get_target_context(pState_Machine, pTarget_State));
+}
+
+#if HSM_SUBMACHINE
+/** \brief Traverse to a state of shared submachine hosted by the given state (external transition).
+ *  Use it to enter the submachine from outside of the host state or from other instance of same submachine.
+ *  Transitions within the current submachine use traverse_state.
+ *
+ * \param pState_Machine state_machine_t* const   pointer to state machine
+ * \param pHost_State const state_t* const        host state of the submachine, must not be in a shared submachine
+ * \param pTarget_State const state_t*            Target state in the shared submachine
+ * \return state_machine_result_t                 Result of state traversal
+ *
+ */
+state_machine_result_t enter_submachine(state_machine_t* const pState_Machine,
+                                        const state_t* const pHost_State,
+                                        const state_t* pTarget_State)
+{
+  return traverse(pState_Machine, pTarget_State, false, pHost_State);
+}
+#endif // HSM_SUBMACHINE
+#endif // HIERARCHICAL_STATES
+
+#if HSM_STATE_CENSUS
+/** \brief Count a new state machine in its current state, e.g. after initializing it with set_state.
+ *
+ * \param pState_Machine const state_machine_t* const   pointer to state machine
+ *
+ */
+void census_add(const state_machine_t* const pState_Machine)
+{
+  assert(get_state(pState_Machine)->Id < HSM_CENSUS_STATES);
+  HSM_FETCH_ADD(&get_census_shard()[get_state(pState_Machine)->Id], 1);
+}
+
+/** \brief Remove a state machine from the census, e.g. before destroying it.
+ *
+ * \param pState_Machine const state_machine_t* const   pointer to state machine
+ *
+ */
+void census_remove(const state_machine_t* const pState_Machine)
+{
+  assert(get_state(pState_Machine)->Id < HSM_CENSUS_STATES);
+  HSM_FETCH_ADD(&get_census_shard()[get_state(pState_Machine)->Id], (uint32_t)-1);
+}
+
+/** \brief Get the number of state machines in each state, in O(states x shards).
+ *  Transitions that run concurrently with the snapshot may be partially counted.
+ *
+ * \param count[] uint32_t   array to store the count of state machines, indexed by Id of state.
+ * \param states uint32_t    number of states to count, at most HSM_CENSUS_STATES
+ *
+ */
+void get_census(uint32_t count[], uint32_t states)
+{
+  for(uint32_t state = 0; state < states; state++)
   {
-    // Traverse the target state to upward,
-    // Till it matches with source state hierarchy level.
-    while(pSource_State->Level < pTarget_State->Level)
+    uint32_t total = 0;
+    for(uint32_t shard = 0; shard < HSM_CENSUS_SHARDS; shard++)
     {
-      pTarget_Path[index++] = pTarget_State;  // Store the target node path.
-      pTarget_State = pTarget_State->Parent;
+      total += HSM_LOAD_ACQUIRE(&Census[shard][state]);
     }
+    count[state] = total;
   }
+}
+#endif // HSM_STATE_CENSUS
 
-  // Now Source & Target are at same hierarchy level.
-  // Traverse the source & target state to upward, till we find their common parent.
-  while(pSource_State->Parent != pTarget_State->Parent)
-  {
-    EXECUTE_HANDLER(pSource_State->Exit, triggered_to_self, pState_Machine);
-    pSource_State = pSource_State->Parent;  // Move source state to upward state.
+#if HSM_STATE_INDEX
+/** \brief Add a new state machine to the list of its current state, e.g. after initializing it with set_state.
+ *
+ * \param pState_Machine state_machine_t* const   pointer to state machine
+ *
+ */
+void index_add(state_machine_t* const pState_Machine)
+{
+  link_machine(pState_Machine, get_state(pState_Machine));
+}
 
-    pTarget_Path[index++] = pTarget_State;  // Store the target node path.
-    pTarget_State = pTarget_State->Parent;    // Move the target state to upward state.
+/** \brief Remove a state machine from the index, e.g. before destroying it.
+ *
+ * \param pState_Machine state_machine_t* const   pointer to state machine
+ *
+ */
+void index_remove(state_machine_t* const pState_Machine)
+{
+  unlink_machine(pState_Machine, get_state(pState_Machine));
+}
+
+/** \brief Get the state machines in the given state, in O(matches).
+ *  Only the state machines whose current (leaf) state is pState are returned, not of its substates.
+ *
+ * \param pState const state_t* const         state
+ * \param pState_Machine[] state_machine_t*   array to store the state machines
+ * \param quantity uint32_t                   size of array
+ * \return uint32_t                           number of state machines stored in the array
+ *
+ */
+uint32_t get_machines_in_state(const state_t* const pState,
+                               state_machine_t* pState_Machine[],
+                               uint32_t quantity)
+{
+  assert(pState->Id < HSM_INDEX_STATES);
+  state_index_t* const pIndex = &State_Index[pState->Id];
+  uint32_t count = 0;
+
+  lock_index(pIndex);
+  for(state_machine_t* pMachine = pIndex->Head;
+      (pMachine != NULL) && (count < quantity);
+      pMachine = pMachine->Index_Next)
+  {
+    pState_Machine[count++] = pMachine;
   }
+  unlock_index(pIndex);
+  return count;
+}
 
-  // Call Exit function before leaving the Source state.
-    EXECUTE_HANDLER(pSource_State->Exit, triggered_to_self, pState_Machine);
-  // Call entry function before entering the target state.
-    EXECUTE_HANDLER(pTarget_State->Entry, triggered_to_self, pState_Machine);
+/** \brief Post an event to all the state machines in the given state, in O(matches).
+ *  The state machines are copied to the array under the lock of the state, and the event is posted
+ *  after the lock is released. Hence a transition of other state machine never waits for the posts.
+ *  The event is not posted to state machines that can't accept it, i.e. that have pending event or full queue.
+ *  It never waits, so it is safe to call while the dispatcher is running on other threads.
+ *  State machines in the state must not be destroyed while it is running.
+ *
+ * \param pState const state_t* const         state
+ * \param event uint32_t                      event to post
+ * \param pState_Machine[] state_machine_t*   array to store the state machines in the state
+ * \param quantity uint32_t                   size of array, the event is posted to at most quantity state machines.
+ * \return uint32_t                           number of state machines the event is posted to,
+ *                                            0 if event is out of range, see is_event_in_range.
+ *
+ */
+uint32_t broadcast_event(const state_t* const pState,
+                         uint32_t event,
+                         state_machine_t* pState_Machine[],
+                         uint32_t quantity)
+{
+  if(!is_event_in_range(event))
+  {
+    return 0;
+  }
 
-    // Now traverse down to the target node & call their entry functions.
-    while(index)
-    {
-      index--;
-      EXECUTE_HANDLER(pTarget_Path[index]->Entry, triggered_to_self, pState_Machine);
-    }
+  const uint32_t matches = get_machines_in_state(pState, pState_Machine, quantity);
+  uint32_t count = 0;
 
-  if(triggered_to_self == true)
+  for(uint32_t index = 0; index < matches; index++)
   {
-    return TRIGGERED_TO_SELF;
+    state_machine_t* const pMachine = pState_Machine[index];
+#if HSM_EVENT_COMPLETION || HSM_EVENT_QUEUE
+    const bool posted = post_event_from_isr(pMachine, event, 0);
+#else
+#if HSM_COMPACT_STATE
+    uint16_t idle = 0;
+    const bool posted = HSM_COMPARE_EXCHANGE(&pMachine->Event, &idle, (uint16_t)event);
+#else
+    uint32_t idle = 0;
+    const bool posted = HSM_COMPARE_EXCHANGE(&pMachine->Event, &idle, event);
+#endif // HSM_COMPACT_STATE
+#endif // HSM_EVENT_COMPLETION || HSM_EVENT_QUEUE
+    count += posted ? 1 : 0;
   }
-  return EVENT_HANDLED;
+  return count;
 }
-#endif // HIERARCHICAL_STATES
+#endif // HSM_STATE_INDEX
+
+#if HIERARCHICAL_STATES && HSM_TRANSITION_CACHE
+/** \brief Get the hit and miss counters of transition cache of calling thread.
+ *
+ * \param pStats transition_cache_stats_t* const   counters
+ *
+ */
+void get_transition_cache_stats(transition_cache_stats_t* const pStats)
+{
+  *pStats = Cache_Stats;
+}
+
+/** \brief Clear the transition cache of all the threads and the counters of calling thread.
+ *  Call it when a dynamically generated state table is released, before its memory is reused.
+ *  Each thread drops its cache on its next transition, hence no state machine must be
+ *  in a transition of the released table while it is called.
+ */
+void clear_transition_cache(void)
+{
+  HSM_FETCH_ADD(&Cache_Epoch, 1);
+  Cache_Stats.Hits = 0;
+  Cache_Stats.Misses = 0;
+}
+#endif // HIERARCHICAL_STATES && HSM_TRANSITION_CACHE
 
+#if HSM_SUBMACHINE
+const state_t Submachine_Root = {0};
+#endif // HSM_SUBMACHINE
@@ -15,6 +15,9 @@
 #ifndef HSM_H
 #define HSM_H
 
+#include <stdint.h>
+#include <stdbool.h>
+
 #ifdef HSM_CONFIG
 #include "hsm_config.h"
 #endif // HSM_CONFIG
@@ -36,6 +39,153 @@
 #define HSM_USE_VARIABLE_LENGTH_ARRAY 1
 #endif
 
+#ifndef HSM_COMPACT_STATE
+//! Disable the compact state machine. State is stored as a pointer to state_t.
+#define HSM_COMPACT_STATE     0
+#endif // HSM_COMPACT_STATE
+
+#ifndef HSM_DISPATCH_BUDGET
+//! Maximum number of handler invocations in single call of dispatch_event, default of dispatch_event_budget.
+//! 0: No limit, dispatch_event returns only when all the events are handled.
+#define HSM_DISPATCH_BUDGET   0
+#endif // HSM_DISPATCH_BUDGET
+
+#ifndef HSM_PUBLISH_STATE
+//! Disable the published state for observer threads.
+#define HSM_PUBLISH_STATE     0
+#endif // HSM_PUBLISH_STATE
+
+#ifndef HSM_EVENT_COMPLETION
+//! Disable the completion token of events posted using post_event.
+#define HSM_EVENT_COMPLETION  0
+#endif // HSM_EVENT_COMPLETION
+
+#ifndef HSM_EVENT_QUEUE
+//! Disable the per state machine event queue. State machine stores only one pending event.
+#define HSM_EVENT_QUEUE       0
+#endif // HSM_EVENT_QUEUE
+
+#ifndef HSM_EVENT_RECORDER
+//! Disable the recorder of events posted using post_event, see hsm_record.h.
+#define HSM_EVENT_RECORDER    0
+#endif // HSM_EVENT_RECORDER
+
+#ifndef HSM_QUEUE_LANES
+//! Number of priority lanes in the event queue (1 to 32). Lane 0 has the highest priority.
+#define HSM_QUEUE_LANES       1
+#endif // HSM_QUEUE_LANES
+
+#ifndef HSM_GROUPED_BATCH
+//! Number of state machines sorted at a time by dispatch_event_grouped (1 to 65535).
+#define HSM_GROUPED_BATCH     256
+#endif // HSM_GROUPED_BATCH
+
+#ifndef HSM_GROUPED_BUCKETS
+//! Number of buckets of the counting sort in dispatch_event_grouped, power of two.
+#define HSM_GROUPED_BUCKETS   64
+#endif // HSM_GROUPED_BUCKETS
+
+#if (HSM_GROUPED_BUCKETS & (HSM_GROUPED_BUCKETS - 1)) != 0
+#error "HSM_GROUPED_BUCKETS must be power of two."
+#endif
+
+#ifndef HSM_STATE_CENSUS
+//! Disable the count of state machines in each state.
+#define HSM_STATE_CENSUS      0
+#endif // HSM_STATE_CENSUS
+
+#if HSM_STATE_CENSUS
+#ifndef HSM_CENSUS_STATES
+//! Number of states counted by census. Id of states must be below it, asserted in debug build.
+#define HSM_CENSUS_STATES     64
+#endif // HSM_CENSUS_STATES
+
+#ifndef HSM_CENSUS_SHARDS
+//! Number of shards of census counters. Each thread updates its own shard.
+#define HSM_CENSUS_SHARDS     8
+#endif // HSM_CENSUS_SHARDS
+#endif // HSM_STATE_CENSUS
+
+#ifndef HSM_STATE_INDEX
+//! Disable the list of state machines in each state.
+#define HSM_STATE_INDEX       0
+#endif // HSM_STATE_INDEX
+
+#if HSM_STATE_INDEX
+#ifndef HSM_INDEX_STATES
+//! Number of states indexed. Id of states must be below it, asserted in debug build.
+#define HSM_INDEX_STATES      64
+#endif // HSM_INDEX_STATES
+#endif // HSM_STATE_INDEX
+
+#ifndef HSM_TRANSITION_CACHE
+//! Number of entries in the per thread cache of traverse_state sequences, power of two. 0: disable cache.
+#define HSM_TRANSITION_CACHE  0
+#endif // HSM_TRANSITION_CACHE
+
+#if HSM_TRANSITION_CACHE
+#if (HSM_TRANSITION_CACHE & (HSM_TRANSITION_CACHE - 1)) != 0
+#error "HSM_TRANSITION_CACHE must be power of two."
+#endif
+
+#ifndef HSM_CACHE_PATH
+//! Maximum number of entry (or exit) actions of a cached transition. Longer transitions are not cached.
+#define HSM_CACHE_PATH        4
+#endif // HSM_CACHE_PATH
+
+#ifndef HSM_CACHE_PROBES
+//! Number of entries probed to find a cached transition.
+#define HSM_CACHE_PROBES      4
+#endif // HSM_CACHE_PROBES
+#endif // HSM_TRANSITION_CACHE
+
+#ifndef HSM_SUBMACHINE
+//! Disable the submachines shared by multiple composite states.
+#define HSM_SUBMACHINE        0
+#endif // HSM_SUBMACHINE
+
+#if HSM_SUBMACHINE
+#if !HIERARCHICAL_STATES
+#error "HSM_SUBMACHINE requires HIERARCHICAL_STATES."
+#endif
+
+//! Flag of Level of a state in the shared submachine.
+#define SUBMACHINE_FLAG       0x80000000u
+
+//! Level of a state in the shared submachine, relative to its host state. Top states of submachine are at level 0.
+#define SUBMACHINE_LEVEL(level)   ((uint32_t)(level) | SUBMACHINE_FLAG)
+
+//! Parent of the top states of shared submachine. It is resolved to the host state of the state machine.
+#define SUBMACHINE_PARENT     (&Submachine_Root)
+#endif // HSM_SUBMACHINE
+
+#if HSM_COMPACT_STATE
+#ifndef HSM_STATE_TABLE
+//! Name of the user defined table of all the states used by compact state machine.
+#define HSM_STATE_TABLE       State_Table
+#endif // HSM_STATE_TABLE
+#endif // HSM_COMPACT_STATE
+
+// Atomic access of a variable shared between dispatcher and other threads.
+#if defined(__GNUC__)
+#define HSM_LOAD_ACQUIRE(pVariable)           __atomic_load_n(pVariable, __ATOMIC_ACQUIRE)
+#define HSM_STORE_RELEASE(pVariable, value)   __atomic_store_n(pVariable, value, __ATOMIC_RELEASE)
+#define HSM_COMPARE_EXCHANGE(pVariable, pExpected, value)  \
+        __atomic_compare_exchange_n(pVariable, pExpected, value, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#define HSM_FETCH_ADD(pVariable, value)       __atomic_fetch_add(pVariable, value, __ATOMIC_RELAXED)
+#else
+// Aligned word access is atomic on the supported targets.
+#define HSM_LOAD_ACQUIRE(pVariable)           (*(pVariable))
+#define HSM_STORE_RELEASE(pVariable, value)   (*(pVariable) = (value))
+// Read-modify-write is not atomic. Post events from a single context or define these macros
+// using the intrinsics or critical section of the target.
+#ifndef HSM_COMPARE_EXCHANGE
+#define HSM_COMPARE_EXCHANGE(pVariable, pExpected, value)  \
+        ((*(pVariable) == *(pExpected)) ? ((*(pVariable) = (value)), true) : ((*(pExpected) = *(pVariable)), false))
+#define HSM_FETCH_ADD(pVariable, value)       ((*(pVariable) += (value)) - (value))
+#endif // HSM_COMPARE_EXCHANGE
+#endif
+
 /*
  *  --------------------- ENUMERATION ---------------------
  */
@@ -47,6 +197,8 @@ typedef enum
   EVENT_UN_HANDLED,    //!< Event could not be handled.
   //!< Handler handled the Event successfully and posted new event to itself.
   TRIGGERED_TO_SELF,
+  //!< Dispatcher exhausted its handler budget or limits. Pending events are not yet dispatched.
+  BUDGET_EXHAUSTED,
 }state_machine_result_t;
 
 /*
@@ -60,9 +212,14 @@ typedef struct finite_state state_t;
 #endif // HIERARCHICAL_STATES
 
 typedef struct state_machine_t state_machine_t;
+typedef struct event_token event_token_t;
+typedef struct event_queue event_queue_t;
+typedef struct event_recorder event_recorder_t;
 typedef state_machine_result_t (*state_handler) (state_machine_t* const State);
 typedef void (*state_machine_event_logger)(uint32_t state_machine, uint32_t state, uint32_t event);
 typedef void (*state_machine_result_logger)(uint32_t state, state_machine_result_t result);
+//! Returns the current time, in the unit of deadline passed to dispatch_event_bounded.
+typedef uint32_t (*dispatch_clock)(void);
 
 //! finite state structure
 struct finite_state{
@@ -70,7 +227,7 @@ struct finite_state{
   state_handler Entry;        //!< Entry action for state
   state_handler Exit;          //!< Exit action for state.
 
-#if STATE_MACHINE_LOGGER
+#if STATE_MACHINE_LOGGER || HSM_COMPACT_STATE || HSM_STATE_CENSUS || HSM_STATE_INDEX
   uint32_t Id;              //!< unique identifier of state within the single state machine
 #endif
 };
@@ -82,7 +239,7 @@ struct hierarchical_state
   state_handler Entry;        //!< Entry action for state
   state_handler Exit;          //!< Exit action for state.
 
-#if STATE_MACHINE_LOGGER
+#if STATE_MACHINE_LOGGER || HSM_COMPACT_STATE || HSM_STATE_CENSUS || HSM_STATE_INDEX
   uint32_t Id;              //!< unique identifier of state within the single state machine
 #endif
 
@@ -94,10 +251,52 @@ struct hierarchical_state
 //! Abstract state machine structure
 struct state_machine_t
 {
+#if HSM_COMPACT_STATE
+   uint16_t Event;          //!< Pending Event for state machine
+   uint16_t State;          //!< Index of state of state machine in the HSM_STATE_TABLE.
+#if HSM_PUBLISH_STATE
+   uint16_t Published;      //!< State after the last completed run to completion step.
+#endif // HSM_PUBLISH_STATE
+#if HSM_EVENT_RECORDER
+   uint32_t Record_Index;   //!< Index of state machine in the recording.
+#endif // HSM_EVENT_RECORDER
+#else
    uint32_t Event;          //!< Pending Event for state machine
+#if HSM_EVENT_RECORDER
+   uint32_t Record_Index;   //!< Index of state machine in the recording. Placed next to Event to use the padding.
+#endif // HSM_EVENT_RECORDER
    const state_t* State;    //!< State of state machine.
+#if HSM_PUBLISH_STATE
+   const state_t* Published;  //!< State after the last completed run to completion step.
+#endif // HSM_PUBLISH_STATE
+#endif // HSM_COMPACT_STATE
+#if HSM_EVENT_COMPLETION
+   event_token_t* Token;    //!< Completion token of pending event. NULL if no event is posted.
+#endif // HSM_EVENT_COMPLETION
+#if HSM_EVENT_QUEUE
+   event_queue_t* Queue;    //!< Queue of posted events. NULL if state machine has no queue.
+#endif // HSM_EVENT_QUEUE
+#if HSM_EVENT_RECORDER
+   event_recorder_t* Recorder;  //!< Recorder of posted events. NULL if events are not recorded.
+#endif // HSM_EVENT_RECORDER
+#if HSM_SUBMACHINE
+   const state_t* Context;  //!< Host state of the current shared submachine. NULL if not in a submachine.
+#endif // HSM_SUBMACHINE
+#if HSM_STATE_INDEX
+   state_machine_t* Index_Next;   //!< Next state machine in the same state
+   state_machine_t* Index_Prev;   //!< Previous state machine in the same state
+#endif // HSM_STATE_INDEX
 };
 
+#if HIERARCHICAL_STATES && HSM_TRANSITION_CACHE
+//! Counters of transition cache of a thread
+typedef struct
+{
+  uint32_t Hits;        //!< Transitions found in the cache
+  uint32_t Misses;      //!< Transitions computed and added to the cache
+}transition_cache_stats_t;
+#endif // HIERARCHICAL_STATES && HSM_TRANSITION_CACHE
+
 /*
  *  --------------------- EXPORTED FUNCTION ---------------------
  */
@@ -106,6 +305,11 @@ struct state_machine_t
 extern "C"  {
 #endif // __cplusplus
 
+#if HSM_COMPACT_STATE
+//! Table of all the states. Index of state in the table must be same as its Id.
+extern const state_t* const HSM_STATE_TABLE[];
+#endif // HSM_COMPACT_STATE
+
 extern state_machine_result_t dispatch_event(state_machine_t* const pState_Machine[],
                                             uint32_t quantity
 #if STATE_MACHINE_LOGGER
@@ -114,16 +318,178 @@ extern state_machine_result_t dispatch_event(state_machine_t* const pState_Machi
 #endif // STATE_MACHINE_LOGGER
                                             );
 
+extern state_machine_result_t dispatch_event_budget(state_machine_t* const pState_Machine[],
+                                                   uint32_t quantity,
+                                                   uint32_t budget
+#if STATE_MACHINE_LOGGER
+                                                   ,state_machine_event_logger event_logger
+                                                   ,state_machine_result_logger result_logger
+#endif // STATE_MACHINE_LOGGER
+                                                   );
+
+extern state_machine_result_t dispatch_event_bounded(state_machine_t* const pState_Machine[],
+                                                    uint32_t quantity,
+                                                    uint32_t maxEvents,
+                                                    dispatch_clock get_time,
+                                                    uint32_t deadline
+#if STATE_MACHINE_LOGGER
+                                                    ,state_machine_event_logger event_logger
+                                                    ,state_machine_result_logger result_logger
+#endif // STATE_MACHINE_LOGGER
+                                                    );
+
+extern state_machine_result_t dispatch_event_grouped(state_machine_t* const pState_Machine[],
+                                                    uint32_t quantity
+#if STATE_MACHINE_LOGGER
+                                                    ,state_machine_event_logger event_logger
+                                                    ,state_machine_result_logger result_logger
+#endif // STATE_MACHINE_LOGGER
+                                                    );
+
 #if HIERARCHICAL_STATES
 extern state_machine_result_t traverse_state(state_machine_t* const pState_Machine,
                                                        const state_t* pTarget_State);
+
+extern state_machine_result_t traverse_state_local(state_machine_t* const pState_Machine,
+                                                   const state_t* pTarget_State);
+
+#if HSM_SUBMACHINE
+//! Parent of the top states of shared submachine, see SUBMACHINE_PARENT.
+extern const state_t Submachine_Root;
+
+extern state_machine_result_t enter_submachine(state_machine_t* const pState_Machine,
+                                               const state_t* const pHost_State,
+                                               const state_t* pTarget_State);
+#endif // HSM_SUBMACHINE
+
+#if HSM_TRANSITION_CACHE
+extern void get_transition_cache_stats(transition_cache_stats_t* const pStats);
+
+extern void clear_transition_cache(void);
+#endif // HSM_TRANSITION_CACHE
 #endif // HIERARCHICAL_STATES
 
 extern state_machine_result_t switch_state(state_machine_t* const pState_Machine,
                                                     const state_t* const pTarget_State);
 
+#if HSM_STATE_CENSUS
+extern void census_add(const state_machine_t* const pState_Machine);
+
+extern void census_remove(const state_machine_t* const pState_Machine);
+
+extern void get_census(uint32_t count[], uint32_t states);
+#endif // HSM_STATE_CENSUS
+
+#if HSM_STATE_INDEX
+extern void index_add(state_machine_t* const pState_Machine);
+
+extern void index_remove(state_machine_t* const pState_Machine);
+
+extern uint32_t get_machines_in_state(const state_t* const pState,
+                                      state_machine_t* pState_Machine[],
+                                      uint32_t quantity);
+
+extern uint32_t broadcast_event(const state_t* const pState,
+                                uint32_t event,
+                                state_machine_t* pState_Machine[],
+                                uint32_t quantity);
+#endif // HSM_STATE_INDEX
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
 
+/*
+ *  --------------------- Inline functions ---------------------
+ */
+
+/** \brief Get the current state of state machine.
+ *
+ * \param pState_Machine const state_machine_t* const   pointer to state machine
+ * \return const state_t*                                current state
+ *
+ */
+static inline const state_t* get_state(const state_machine_t* const pState_Machine)
+{
+#if HSM_COMPACT_STATE
+  return HSM_STATE_TABLE[pState_Machine->State];
+#else
+  return pState_Machine->State;
+#endif // HSM_COMPACT_STATE
+}
+
+/** \brief Set the state of state machine without calling any entry/exit action.
+ *  Use it to initialize the state machine.
+ *
+ * \param pState_Machine state_machine_t* const   pointer to state machine
+ * \param pState const state_t* const             new state of state machine
+ *
+ */
+static inline void set_state(state_machine_t* const pState_Machine, const state_t* const pState)
+{
+#if HSM_COMPACT_STATE
+  pState_Machine->State = (uint16_t)pState->Id;
+#else
+  pState_Machine->State = pState;
+#endif // HSM_COMPACT_STATE
+#if HSM_PUBLISH_STATE
+  HSM_STORE_RELEASE(&pState_Machine->Published, pState_Machine->State);
+#endif // HSM_PUBLISH_STATE
+}
+
+/** \brief Check if the event fits in the Event of state machine.
+ *  In compact state machine Event is 16-bit, hence events above UINT16_MAX are rejected by
+ *  post_event, post_event_from_isr, broadcast_event and replay_events.
+ *
+ * \param event uint32_t    event to post
+ * \return bool             true if the event can be posted without truncation.
+ *
+ */
+static inline bool is_event_in_range(uint32_t event)
+{
+#if HSM_COMPACT_STATE
+  return event <= UINT16_MAX;
+#else
+  (void)event;
+  return true;
+#endif // HSM_COMPACT_STATE
+}
+
+#if HSM_SUBMACHINE
+/** \brief Set the state of state machine in a shared submachine without calling any entry/exit action.
+ *  Use it to initialize the state machine.
+ *
+ * \param pState_Machine state_machine_t* const   pointer to state machine
+ * \param pHost_State const state_t* const        host state of the submachine
+ * \param pState const state_t* const             new state of state machine in the submachine
+ *
+ */
+static inline void set_submachine_state(state_machine_t* const pState_Machine,
+                                        const state_t* const pHost_State,
+                                        const state_t* const pState)
+{
+  pState_Machine->Context = pHost_State;
+  set_state(pState_Machine, pState);
+}
+#endif // HSM_SUBMACHINE
+
+#if HSM_PUBLISH_STATE
+/** \brief Get the state of state machine after its last completed run to completion step.
+ *  It is wait-free and safe to call from any thread while the dispatcher is running.
+ *  It never returns an intermediate state of a transition in progress.
+ *
+ * \param pState_Machine const state_machine_t* const   pointer to state machine
+ * \return const state_t*                                published state
+ *
+ */
+static inline const state_t* observe_state(const state_machine_t* const pState_Machine)
+{
+#if HSM_COMPACT_STATE
+  return HSM_STATE_TABLE[HSM_LOAD_ACQUIRE(&pState_Machine->Published)];
+#else
+  return HSM_LOAD_ACQUIRE(&pState_Machine->Published);
+#endif // HSM_COMPACT_STATE
+}
+#endif // HSM_PUBLISH_STATE
+
 #endif // HSM_H
@@ -0,0 +1,170 @@
+/**
+ * \file
+ * \brief Bulk transition engine for flat finite state machines.
+
+ * \author  Nandkishor Biradar
+ * \date    19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+/*
+ *  --------------------- INCLUDE FILES ---------------------
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <assert.h>
+
+#if defined(__GNUC__) && (defined(__AVX512F__) || defined(__AVX2__))
+#include <immintrin.h>
+#endif
+
+#include "hsm_bulk.h"
+
+/*
+ *  --------------------- DEFINITION ---------------------
+ */
+
+#if defined(__GNUC__) && defined(__AVX512F__)
+#define BULK_LANES    16      //!< Number of instances processed by one AVX-512 gather
+#elif defined(__GNUC__) && defined(__AVX2__)
+#define BULK_LANES    8       //!< Number of instances processed by one AVX2 gather
+#endif
+
+/*
+ *  --------------------- FUNCTION BODY ---------------------
+ */
+
+/** \brief Calls exit action of source state and entry action of target state of an instance.
+ */
+static inline void execute_actions(const bulk_state_table_t* const pTable, uint32_t instance,
+                                   uint16_t source, uint16_t target)
+{
+  if((pTable->Exit != NULL) && (pTable->Exit[source] != NULL))
+  {
+    pTable->Exit[source](instance);
+  }
+  if((pTable->Entry != NULL) && (pTable->Entry[target] != NULL))
+  {
+    pTable->Entry[target](instance);
+  }
+}
+
+#ifdef BULK_LANES
+/** \brief Applies the transition row to BULK_LANES instances at a time.
+ *
+ * \param pTable const bulk_state_table_t* const  transition table
+ * \param pRow const uint16_t* const              transition row of the event
+ * \param State[] uint16_t                        states of instances
+ * \param quantity uint32_t                       number of instances
+ * \param pChanged uint32_t* const                incremented for each instance that changed the state
+ * \return uint32_t number of instances processed. Remaining instances are left to scalar path.
+ *
+ */
+static uint32_t dispatch_simd(const bulk_state_table_t* const pTable, const uint16_t* const pRow,
+                              uint16_t State[], uint32_t quantity, uint32_t* const pChanged)
+{
+  // Gather instructions load 32-bit elements, widen the transition row.
+  int32_t row[HSM_BULK_SIMD_MAX_STATES];
+  for(uint32_t state = 0; state < pTable->States; state++)
+  {
+    row[state] = pRow[state];
+  }
+
+  uint32_t index = 0;
+  for(; index + BULK_LANES <= quantity; index += BULK_LANES)
+  {
+    uint16_t source[BULK_LANES];
+#if defined(__AVX512F__)
+    __m256i packed = _mm256_loadu_si256((const __m256i*)&State[index]);
+    __m512i current = _mm512_cvtepu16_epi32(packed);
+    __m512i next = _mm512_i32gather_epi32(current, row, 4);
+    uint32_t mask = _mm512_cmpneq_epi32_mask(current, next);
+    if(mask == 0)
+    {
+      continue;
+    }
+    _mm256_storeu_si256((__m256i*)source, packed);
+    _mm256_storeu_si256((__m256i*)&State[index], _mm512_cvtepi32_epi16(next));
+#else
+    __m128i packed = _mm_loadu_si128((const __m128i*)&State[index]);
+    __m256i current = _mm256_cvtepu16_epi32(packed);
+    __m256i next = _mm256_i32gather_epi32(row, current, 4);
+    __m256i equal = _mm256_cmpeq_epi32(current, next);
+    uint32_t mask = ~(uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(equal)) & 0xFFu;
+    if(mask == 0)
+    {
+      continue;
+    }
+    _mm_storeu_si128((__m128i*)source, packed);
+    _mm_storeu_si128((__m128i*)&State[index],
+                     _mm_packus_epi32(_mm256_castsi256_si128(next), _mm256_extracti128_si256(next, 1)));
+#endif
+
+    // Execute actions only for lanes that changed the state.
+    while(mask)
+    {
+      uint32_t lane = (uint32_t)__builtin_ctz(mask);
+      mask &= mask - 1;
+      (*pChanged)++;
+      execute_actions(pTable, index + lane, source[lane], State[index + lane]);
+    }
+  }
+  return index;
+}
+#endif // BULK_LANES
+
+/** \brief Applies an event to all instances of a bulk state machine.
+ *  It calls exit action of source state and entry action of target state,
+ *  only for the instances that changed the state.
+ *
+ * \param pTable const bulk_state_table_t* const  transition table
+ * \param State[] uint16_t                        states of instances
+ * \param quantity uint32_t                       number of instances. State of each instance must be less than States.
+ * \param event uint16_t                          event to apply. It must be less than Events.
+ * \return uint32_t                               number of instances that changed the state
+ *
+ */
+uint32_t bulk_dispatch_event(const bulk_state_table_t* const pTable,
+                             uint16_t State[],
+                             uint32_t quantity,
+                             uint16_t event)
+{
+  const uint16_t* const pRow = &pTable->Transition[(uint32_t)event * pTable->States];
+  uint32_t changed = 0;
+  uint32_t index = 0;
+
+#ifndef NDEBUG
+  // Transition row is indexed by the state without bounds check.
+  assert(event < pTable->Events);
+  for(uint32_t instance = 0; instance < quantity; instance++)
+  {
+    assert(State[instance] < pTable->States);
+  }
+#endif // NDEBUG
+
+#ifdef BULK_LANES
+  if(pTable->States <= HSM_BULK_SIMD_MAX_STATES)
+  {
+    index = dispatch_simd(pTable, pRow, State, quantity, &changed);
+  }
+#endif // BULK_LANES
+
+  for(; index < quantity; index++)
+  {
+    const uint16_t source = State[index];
+    const uint16_t target = pRow[source];
+    if(target != source)
+    {
+      State[index] = target;
+      changed++;
+      execute_actions(pTable, index, source, target);
+    }
+  }
+  return changed;
+}
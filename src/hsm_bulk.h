@@ -0,0 +1,71 @@
+/**
+ * \file
+ * \brief Bulk transition engine for flat finite state machines.
+ *
+ *  The bulk engine applies one event to a large number of instances of the same
+ *  finite state machine. The states of all instances are stored in contiguous
+ *  uint16_t array and the transitions are stored in state x event matrix.
+ *  It uses AVX-512/AVX2 gather when compiled for a target that supports it.
+ *  The gather doesn't check the bounds, hence the state of each instance must be
+ *  less than the number of states. Debug builds assert it.
+
+ * \author  Nandkishor Biradar
+ * \date    19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+#ifndef HSM_BULK_H
+#define HSM_BULK_H
+
+/*
+ *  --------------------- DEFINITION ---------------------
+ */
+
+#ifndef HSM_BULK_SIMD_MAX_STATES
+//! Maximum number of states supported by SIMD path. Larger tables use scalar path.
+#define HSM_BULK_SIMD_MAX_STATES    256
+#endif // HSM_BULK_SIMD_MAX_STATES
+
+/*
+ *  --------------------- STRUCTURE ---------------------
+ */
+
+//! Entry/Exit action of bulk state machine. It receives the index of instance.
+typedef void (*bulk_action)(uint32_t instance);
+
+//! State transition table of bulk state machine
+typedef struct
+{
+  //! Next state for each state and event. Indexed as Transition[event * States + state].
+  //! A state that doesn't handle the event has itself as next state.
+  //! Each entry must be less than States, the SIMD gather doesn't check the bounds.
+  const uint16_t* Transition;
+  const bulk_action* Entry;   //!< Entry action of each state. Array or entries can be NULL.
+  const bulk_action* Exit;    //!< Exit action of each state. Array or entries can be NULL.
+  uint16_t States;            //!< Number of states
+  uint16_t Events;            //!< Number of events
+}bulk_state_table_t;
+
+/*
+ *  --------------------- EXPORTED FUNCTION ---------------------
+ */
+
+#ifdef __cplusplus
+extern "C"  {
+#endif // __cplusplus
+
+extern uint32_t bulk_dispatch_event(const bulk_state_table_t* const pTable,
+                                    uint16_t State[],
+                                    uint32_t quantity,
+                                    uint16_t event);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // HSM_BULK_H
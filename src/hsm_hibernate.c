@@ -0,0 +1,414 @@
+/**
+ * \file
+ * \brief Hibernation of idle state machines into a compact cold store.
+
+ * \author  Nandkishor Biradar
+ * \date    19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+/*
+ *  --------------------- INCLUDE FILES ---------------------
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "hsm.h"
+#include "hsm_post.h"
+#include "hsm_pool.h"
+#include "hsm_hibernate.h"
+
+/*
+ *  --------------------- FUNCTION BODY ---------------------
+ */
+
+//! Returns the address of cold record.
+static inline uint8_t* get_record(const machine_store_t* const pStore, uint32_t index)
+{
+  return pStore->Cold + ((size_t)index * pStore->Record_Size);
+}
+
+//! Returns the user data of instance that follows state_machine_t.
+static inline uint8_t* get_user_data(state_machine_t* const pState_Machine)
+{
+  return (uint8_t*)(void*)pState_Machine + sizeof(state_machine_t);
+}
+
+//! Store the state and recorder of instance in the cold record.
+static inline void write_header(uint8_t* const pRecord, const state_machine_t* const pState_Machine)
+{
+  memcpy(pRecord, &pState_Machine->State, COLD_STATE_SIZE);
+#if HSM_EVENT_RECORDER
+  memcpy(pRecord + COLD_STATE_SIZE, &pState_Machine->Recorder, sizeof(pState_Machine->Recorder));
+  memcpy(pRecord + COLD_STATE_SIZE + sizeof(pState_Machine->Recorder),
+         &pState_Machine->Record_Index, sizeof(pState_Machine->Record_Index));
+#endif // HSM_EVENT_RECORDER
+}
+
+/** \brief Load the state and recorder stored in the cold record into a header.
+ *  State is decoded using the header, it works with both pointer and compact state.
+ */
+static inline void read_header(const uint8_t* const pRecord, state_machine_t* const pHeader)
+{
+  memcpy(&pHeader->State, pRecord, COLD_STATE_SIZE);
+#if HSM_EVENT_RECORDER
+  memcpy(&pHeader->Recorder, pRecord + COLD_STATE_SIZE, sizeof(pHeader->Recorder));
+  memcpy(&pHeader->Record_Index, pRecord + COLD_STATE_SIZE + sizeof(pHeader->Recorder),
+         sizeof(pHeader->Record_Index));
+#endif // HSM_EVENT_RECORDER
+}
+
+//! Release the cold record to the free list.
+static inline void release_record(machine_store_t* const pStore, uint32_t index)
+{
+  memcpy(get_record(pStore, index), &pStore->Cold_Free, sizeof(pStore->Cold_Free));
+  pStore->Cold_Free = index;
+  pStore->Cold_Used--;
+}
+
+/** \brief Initialize the store of state machine instances.
+ *
+ * \param pStore machine_store_t* const   store to initialize
+ * \param pPool machine_pool_t* const     initialized pool of hot instances
+ * \param pCold void* const               memory of COLD_STORE_SIZE(dataSize, coldCapacity) bytes
+ * \param coldCapacity uint32_t           maximum number of hibernated instances
+ * \param dataSize size_t                 bytes of user data, following state_machine_t, to keep in the cold record.
+ *                                        Remaining user data is cleared on rehydration.
+ * \param pLocation uint32_t* const       array of location, one per id
+ * \param pLast_Active uint32_t* const    array of time of last posted event, one per id
+ * \param machines uint32_t               number of ids
+ * \param get_time dispatch_clock         clock of idle time
+ * \return bool false if user data doesn't fit in the slot of pool or cold capacity is too large.
+ *
+ */
+bool init_machine_store(machine_store_t* const pStore,
+                        machine_pool_t* const pPool,
+                        void* const pCold,
+                        uint32_t coldCapacity,
+                        size_t dataSize,
+                        uint32_t* const pLocation,
+                        uint32_t* const pLast_Active,
+                        uint32_t machines,
+                        dispatch_clock get_time)
+{
+  if(((dataSize + sizeof(state_machine_t)) > pPool->Slot_Size)
+     || (coldCapacity >= LOCATION_COLD))
+  {
+    return false;
+  }
+
+  pStore->Pool = pPool;
+  pStore->Cold = (uint8_t*)pCold;
+  pStore->Record_Size = COLD_RECORD_SIZE(dataSize);
+  pStore->Data_Size = dataSize;
+  pStore->Cold_Capacity = coldCapacity;
+  pStore->Cold_Unused = 0;
+  pStore->Cold_Free = POOL_END;
+  pStore->Cold_Used = 0;
+  pStore->Location = pLocation;
+  pStore->Last_Active = pLast_Active;
+  pStore->Machines = machines;
+  pStore->Cursor = 0;
+  pStore->get_time = get_time;
+
+  memset(pLocation, 0xFF, (size_t)machines * sizeof(pLocation[0]));   // LOCATION_NONE
+  memset(pLast_Active, 0, (size_t)machines * sizeof(pLast_Active[0]));
+  return true;
+}
+
+/** \brief Create the instance of id in the pool. See create_machine.
+ *
+ * \param pStore machine_store_t* const         store
+ * \param id uint32_t                           id of instance
+ * \param pInitial_State const state_t* const   initial state
+ * \return state_machine_t*                     new instance or NULL if id is in use or pool is full.
+ *
+ */
+state_machine_t* store_create_machine(machine_store_t* const pStore,
+                                      uint32_t id,
+                                      const state_t* const pInitial_State)
+{
+  if((id >= pStore->Machines) || (pStore->Location[id] != LOCATION_NONE))
+  {
+    return NULL;
+  }
+
+  state_machine_t* const pState_Machine = create_machine(pStore->Pool, pInitial_State);
+  if(pState_Machine != NULL)
+  {
+    pStore->Location[id] = get_pool_index(pStore->Pool, pState_Machine);
+    pStore->Last_Active[id] = pStore->get_time();
+  }
+  return pState_Machine;
+}
+
+/** \brief Destroy the instance of id, whether it is hot or hibernated.
+ *
+ * \param pStore machine_store_t* const   store
+ * \param id uint32_t                     id of instance
+ *
+ */
+void store_destroy_machine(machine_store_t* const pStore, uint32_t id)
+{
+  const uint32_t location = pStore->Location[id];
+  if(location == LOCATION_NONE)
+  {
+    return;
+  }
+
+  if((location & LOCATION_COLD) != 0)
+  {
+#if HSM_STATE_CENSUS
+    state_machine_t header;
+    read_header(get_record(pStore, location & ~LOCATION_COLD), &header);
+    census_remove(&header);
+#endif // HSM_STATE_CENSUS
+    release_record(pStore, location & ~LOCATION_COLD);
+  }
+  else
+  {
+    destroy_machine(pStore->Pool, get_pool_machine(pStore->Pool, location));
+  }
+  pStore->Location[id] = LOCATION_NONE;
+}
+
+/** \brief Hibernate the instance of id. Its state, recorder and user data are packed into a cold record
+ *  and its slot is released to the pool. Exit action of the current state is not called.
+ *  Instance stays counted in the census, but it is removed from the index until it is rehydrated.
+ *
+ * \param pStore machine_store_t* const   store
+ * \param id uint32_t                     id of instance
+ * \return bool false if instance is not hot, it has pending event or queue, it is in a shared submachine
+ *              or cold store is full.
+ *
+ */
+bool hibernate_machine(machine_store_t* const pStore, uint32_t id)
+{
+  const uint32_t location = pStore->Location[id];
+  if((location == LOCATION_NONE) || ((location & LOCATION_COLD) != 0))
+  {
+    return false;
+  }
+
+  state_machine_t* const pState_Machine = get_pool_machine(pStore->Pool, location);
+  if(pState_Machine->Event != 0)
+  {
+    return false;
+  }
+#if HSM_EVENT_QUEUE
+  // Queue is owned by the user and may have posted events.
+  if(pState_Machine->Queue != NULL)
+  {
+    return false;
+  }
+#endif // HSM_EVENT_QUEUE
+#if HSM_SUBMACHINE
+  // Host state of submachine is not kept in the cold record.
+  if(pState_Machine->Context != NULL)
+  {
+    return false;
+  }
+#endif // HSM_SUBMACHINE
+
+  uint32_t index;
+  if(pStore->Cold_Free != POOL_END)
+  {
+    index = pStore->Cold_Free;
+    memcpy(&pStore->Cold_Free, get_record(pStore, index), sizeof(pStore->Cold_Free));
+  }
+  else if(pStore->Cold_Unused < pStore->Cold_Capacity)
+  {
+    index = pStore->Cold_Unused++;
+  }
+  else
+  {
+    return false;
+  }
+
+  uint8_t* const pRecord = get_record(pStore, index);
+  write_header(pRecord, pState_Machine);
+  memcpy(pRecord + COLD_HEADER_SIZE, get_user_data(pState_Machine), pStore->Data_Size);
+  pStore->Cold_Used++;
+
+#if HSM_STATE_CENSUS
+  // destroy_machine removes the instance from the census, keep it counted in its state.
+  census_add(pState_Machine);
+#endif // HSM_STATE_CENSUS
+  destroy_machine(pStore->Pool, pState_Machine);
+  pStore->Location[id] = LOCATION_COLD | index;
+  return true;
+}
+
+/** \brief Hibernate the instances that have no posted event for the idle time.
+ *  It checks the given number of ids per call, continuing from where the last call stopped,
+ *  so that a large store can be swept in small steps.
+ *
+ * \param pStore machine_store_t* const   store
+ * \param idleTime uint32_t               idle time in the unit of clock of store
+ * \param quantity uint32_t               number of ids to check
+ * \return uint32_t                       number of hibernated instances
+ *
+ */
+uint32_t hibernate_idle(machine_store_t* const pStore, uint32_t idleTime, uint32_t quantity)
+{
+  const uint32_t now = pStore->get_time();
+  uint32_t hibernated = 0;
+
+  if(quantity > pStore->Machines)
+  {
+    quantity = pStore->Machines;
+  }
+
+  for(uint32_t count = 0; count < quantity; count++)
+  {
+    const uint32_t id = pStore->Cursor;
+    pStore->Cursor = (id + 1 < pStore->Machines) ? id + 1 : 0;
+
+    if(((uint32_t)(now - pStore->Last_Active[id]) >= idleTime)
+       && hibernate_machine(pStore, id))
+    {
+      hibernated++;
+    }
+  }
+  return hibernated;
+}
+
+/** \brief Get the hot instance of id. Hibernated instance is rehydrated into a new slot
+ *  with the same state, recorder and user data, without calling any entry action.
+ *  Rehydrated instance is considered active at the current time, see hibernate_idle.
+ *  Pointers to the instance are invalid once it is hibernated, address it by id.
+ *
+ * \param pStore machine_store_t* const   store
+ * \param id uint32_t                     id of instance
+ * \return state_machine_t*               instance or NULL if id has no instance or pool is full.
+ *
+ */
+state_machine_t* wake_machine(machine_store_t* const pStore, uint32_t id)
+{
+  const uint32_t location = pStore->Location[id];
+  if(location == LOCATION_NONE)
+  {
+    return NULL;
+  }
+  if((location & LOCATION_COLD) == 0)
+  {
+    return get_pool_machine(pStore->Pool, location);
+  }
+
+  const uint32_t index = location & ~LOCATION_COLD;
+  const uint8_t* const pRecord = get_record(pStore, index);
+
+  state_machine_t header;
+  read_header(pRecord, &header);
+
+  state_machine_t* const pState_Machine = create_machine(pStore->Pool, get_state(&header));
+  if(pState_Machine == NULL)
+  {
+    return NULL;
+  }
+#if HSM_STATE_CENSUS
+  // Hibernated instance is already counted in its state, see hibernate_machine.
+  census_remove(pState_Machine);
+#endif // HSM_STATE_CENSUS
+#if HSM_EVENT_RECORDER
+  pState_Machine->Recorder = header.Recorder;
+  pState_Machine->Record_Index = header.Record_Index;
+#endif // HSM_EVENT_RECORDER
+  memcpy(get_user_data(pState_Machine), pRecord + COLD_HEADER_SIZE, pStore->Data_Size);
+
+  release_record(pStore, index);
+  pStore->Location[id] = get_pool_index(pStore->Pool, pState_Machine);
+  pStore->Last_Active[id] = pStore->get_time();
+  return pState_Machine;
+}
+
+/** \brief Post an event to the instance of id, rehydrate it if it is hibernated.
+ *
+ * \param pStore machine_store_t* const   store
+ * \param id uint32_t                     id of instance
+ * \param event uint32_t                  event to post
+ * \param pToken event_token_t* const     completion token, see post_event.
+ * \return state_machine_t*               instance to dispatch or NULL if event is not posted.
+ *
+ */
+state_machine_t* post_to_store(machine_store_t* const pStore,
+                               uint32_t id,
+                               uint32_t event,
+                               event_token_t* const pToken)
+{
+  state_machine_t* const pState_Machine = wake_machine(pStore, id);
+  if((pState_Machine == NULL) || !post_event(pState_Machine, event, pToken))
+  {
+    return NULL;
+  }
+
+  pStore->Last_Active[id] = pStore->get_time();
+  return pState_Machine;
+}
+
+/** \brief Post an event to all the instances of store in the given state, in O(ids).
+ *  Unlike broadcast_event, it reaches the hibernated instances, which are rehydrated to post the event.
+ *  The event is not posted to the instances that can't accept it, i.e. that have pending event or full queue,
+ *  or that can't be rehydrated as pool is full.
+ *
+ * \param pStore machine_store_t* const       store
+ * \param pState const state_t* const         state
+ * \param event uint32_t                      event to post
+ * \param pState_Machine[] state_machine_t*   array to store the instances to dispatch
+ * \param quantity uint32_t                   size of array, the event is posted to at most quantity instances.
+ * \return uint32_t                           number of instances the event is posted to
+ *
+ */
+uint32_t broadcast_to_store(machine_store_t* const pStore,
+                            const state_t* const pState,
+                            uint32_t event,
+                            state_machine_t* pState_Machine[],
+                            uint32_t quantity)
+{
+  uint32_t count = 0;
+
+  for(uint32_t id = 0; (id < pStore->Machines) && (count < quantity); id++)
+  {
+    const uint32_t location = pStore->Location[id];
+    state_machine_t* pMachine = NULL;
+
+    if(location == LOCATION_NONE)
+    {
+      continue;
+    }
+
+    if((location & LOCATION_COLD) != 0)
+    {
+      state_machine_t header;
+      read_header(get_record(pStore, location & ~LOCATION_COLD), &header);
+      if(get_state(&header) == pState)
+      {
+        pMachine = post_to_store(pStore, id, event, NULL);
+      }
+    }
+    else
+    {
+      state_machine_t* const pHot = get_pool_machine(pStore->Pool, location);
+      // Posted without blocking, as for broadcast_event.
+      if((get_state(pHot) == pState) && post_event_from_isr(pHot, event, 0))
+      {
+        pStore->Last_Active[id] = pStore->get_time();
+        pMachine = pHot;
+      }
+    }
+
+    if(pMachine != NULL)
+    {
+      pState_Machine[count++] = pMachine;
+    }
+  }
+  return count;
+}
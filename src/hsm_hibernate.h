@@ -0,0 +1,144 @@
+/**
+ * \file
+ * \brief Hibernation of idle state machines into a compact cold store.
+ *
+ *  The machine store addresses the instances of a pool by a stable id. An instance that
+ *  is idle longer than a threshold is hibernated: its state and the leading bytes of its
+ *  user data are packed into a cold record and its slot is released to the pool.
+ *  Posting an event to a hibernated instance rehydrates it into a new slot, so the handlers
+ *  see the same state and data. Only the hot instances occupy the pool, size it for the
+ *  active instances and the cold store for the rest. Hibernated instances stay counted in the
+ *  census and are reached by broadcast_to_store, but they are not listed in the index.
+ *  It is not thread safe, use the store from the dispatcher thread.
+
+ * \author  Nandkishor Biradar
+ * \date    19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+#ifndef HSM_HIBERNATE_H
+#define HSM_HIBERNATE_H
+
+#include <stddef.h>
+
+/*
+ *  --------------------- DEFINITION ---------------------
+ */
+
+//! Size of state stored in the cold record, same as the State of state_machine_t.
+#define COLD_STATE_SIZE     sizeof(((state_machine_t*)0)->State)
+
+#if HSM_EVENT_RECORDER
+//! Size of recorder and index in the recording, stored in the cold record.
+#define COLD_RECORDER_SIZE  \
+  (sizeof(((state_machine_t*)0)->Recorder) + sizeof(((state_machine_t*)0)->Record_Index))
+#else
+#define COLD_RECORDER_SIZE  0
+#endif // HSM_EVENT_RECORDER
+
+//! Size of fields of state_machine_t stored in the cold record.
+#define COLD_HEADER_SIZE    (COLD_STATE_SIZE + COLD_RECORDER_SIZE)
+
+//! Size of cold record that keeps the given bytes of user data. It can hold the index of next free record.
+#define COLD_RECORD_SIZE(dataSize)                                  \
+  (((COLD_HEADER_SIZE + (size_t)(dataSize)) < sizeof(uint32_t))     \
+   ? sizeof(uint32_t) : (COLD_HEADER_SIZE + (size_t)(dataSize)))
+
+//! Size of memory required for the cold store of given number of records.
+#define COLD_STORE_SIZE(dataSize, capacity)   (COLD_RECORD_SIZE(dataSize) * (size_t)(capacity))
+
+//! Location of an id that has no instance.
+#define LOCATION_NONE       UINT32_MAX
+
+//! Flag of location of a hibernated instance, remaining bits are index of cold record.
+#define LOCATION_COLD       0x80000000u
+
+/*
+ *  --------------------- STRUCTURE ---------------------
+ */
+
+//! Instances of pool addressed by id, hibernated into cold store when idle
+typedef struct
+{
+  machine_pool_t* Pool;     //!< Pool of hot instances
+  uint8_t* Cold;            //!< User provided memory of cold records
+  size_t Record_Size;       //!< Size of cold record
+  size_t Data_Size;         //!< Bytes of user data, following state_machine_t, kept in the cold record
+  uint32_t Cold_Capacity;   //!< Total number of cold records
+  uint32_t Cold_Unused;     //!< Index of first record that is never used
+  uint32_t Cold_Free;       //!< Head of the list of released records, POOL_END if empty
+  uint32_t Cold_Used;       //!< Number of hibernated instances
+  uint32_t* Location;       //!< Slot index or LOCATION_COLD | record index of each id
+  uint32_t* Last_Active;    //!< Time of the last posted event of each id
+  uint32_t Machines;        //!< Number of ids
+  uint32_t Cursor;          //!< Next id to check by hibernate_idle
+  dispatch_clock get_time;  //!< Clock of idle time
+}machine_store_t;
+
+/*
+ *  --------------------- EXPORTED FUNCTION ---------------------
+ */
+
+#ifdef __cplusplus
+extern "C"  {
+#endif // __cplusplus
+
+extern bool init_machine_store(machine_store_t* const pStore,
+                               machine_pool_t* const pPool,
+                               void* const pCold,
+                               uint32_t coldCapacity,
+                               size_t dataSize,
+                               uint32_t* const pLocation,
+                               uint32_t* const pLast_Active,
+                               uint32_t machines,
+                               dispatch_clock get_time);
+
+extern state_machine_t* store_create_machine(machine_store_t* const pStore,
+                                             uint32_t id,
+                                             const state_t* const pInitial_State);
+
+extern void store_destroy_machine(machine_store_t* const pStore, uint32_t id);
+
+extern bool hibernate_machine(machine_store_t* const pStore, uint32_t id);
+
+extern uint32_t hibernate_idle(machine_store_t* const pStore, uint32_t idleTime, uint32_t quantity);
+
+extern state_machine_t* wake_machine(machine_store_t* const pStore, uint32_t id);
+
+extern state_machine_t* post_to_store(machine_store_t* const pStore,
+                                      uint32_t id,
+                                      uint32_t event,
+                                      event_token_t* const pToken);
+
+extern uint32_t broadcast_to_store(machine_store_t* const pStore,
+                                   const state_t* const pState,
+                                   uint32_t event,
+                                   state_machine_t* pState_Machine[],
+                                   uint32_t quantity);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+/*
+ *  --------------------- Inline functions ---------------------
+ */
+
+/** \brief Check if the instance of id is hibernated.
+ *
+ * \param pStore const machine_store_t* const   store
+ * \param id uint32_t                           id of instance
+ * \return bool true if instance is in the cold store.
+ *
+ */
+static inline bool is_hibernated(const machine_store_t* const pStore, uint32_t id)
+{
+  return (pStore->Location[id] != LOCATION_NONE) && ((pStore->Location[id] & LOCATION_COLD) != 0);
+}
+
+#endif // HSM_HIBERNATE_H
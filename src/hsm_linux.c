@@ -0,0 +1,318 @@
+/**
+ * \file
+ * \brief Linux runtime of state machine dispatcher.
+
+ * \author  Nandkishor Biradar
+ * \date    19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+/*
+ *  --------------------- INCLUDE FILES ---------------------
+ */
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L   // clock_gettime in strict ISO C mode
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
+#include "hsm.h"
+#include "hsm_post.h"
+#include "hsm_linux.h"
+
+/*
+ *  --------------------- DEFINITION ---------------------
+ */
+
+#define NANOSECONDS_PER_SECOND      1000000000u
+#define NANOSECONDS_PER_MILLISECOND 1000000u
+
+/*
+ *  --------------------- FUNCTION BODY ---------------------
+ */
+
+//! Returns current time of CLOCK_MONOTONIC in nanoseconds.
+static uint64_t get_time(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return ((uint64_t)now.tv_sec * NANOSECONDS_PER_SECOND) + (uint64_t)now.tv_nsec;
+}
+
+//! Makes the runtime descriptor readable.
+static void signal_runtime(linux_runtime_t* const pRuntime)
+{
+  const uint64_t count = 1;
+  // Write fails only if the counter is saturated, runtime is readable in that case.
+  (void)!write(pRuntime->Event_Fd, &count, sizeof(count));
+}
+
+/** \brief Arm the timerfd with the earliest expiry of running timers.
+ *  timerfd is reprogrammed only if the earliest expiry is changed.
+ */
+static void arm_timer(linux_runtime_t* const pRuntime)
+{
+  uint64_t earliest = 0;
+  for(uint32_t index = 0; index < pRuntime->Total_Timers; index++)
+  {
+    const uint64_t expiry = pRuntime->Timers[index].Expiry;
+    if((expiry != 0) && ((earliest == 0) || (expiry < earliest)))
+    {
+      earliest = expiry;
+    }
+  }
+
+  if(earliest == pRuntime->Armed)
+  {
+    return;
+  }
+
+  // it_value of zero disarms the timer.
+  struct itimerspec spec = {0};
+  spec.it_value.tv_sec = (time_t)(earliest / NANOSECONDS_PER_SECOND);
+  spec.it_value.tv_nsec = (long)(earliest % NANOSECONDS_PER_SECOND);
+  timerfd_settime(pRuntime->Timer_Fd, TFD_TIMER_ABSTIME, &spec, NULL);
+  pRuntime->Armed = earliest;
+}
+
+/** \brief Post the events of expired timers.
+ *  Events are posted using post_event_from_isr, as the dispatcher must not block on a full queue
+ *  having OVERFLOW_BLOCK policy. It is the only thread that can make room in the queue.
+ *
+ * \return uint32_t number of expired timers that couldn't be posted as state machine is busy or its queue is full.
+ */
+static uint32_t fire_timers(linux_runtime_t* const pRuntime)
+{
+  uint32_t blocked = 0;
+  const uint64_t now = get_time();
+
+  for(uint32_t index = 0; index < pRuntime->Total_Timers; index++)
+  {
+    runtime_timer_t* const pTimer = &pRuntime->Timers[index];
+    if((pTimer->Expiry == 0) || (pTimer->Expiry > now))
+    {
+      continue;
+    }
+
+    if(post_event_from_isr(pTimer->Machine, pTimer->Event, 0))
+    {
+      pTimer->Expiry = 0;
+    }
+    else
+    {
+      blocked++;
+    }
+  }
+  return blocked;
+}
+
+/** \brief Initialize the runtime.
+ *
+ * \param pRuntime linux_runtime_t* const             runtime to initialize
+ * \param pState_Machine[] state_machine_t* const     array of state machines in priority order
+ * \param quantity uint32_t                           number of state machines
+ * \param pTimers runtime_timer_t* const              user provided timers. It can be NULL.
+ * \param totalTimers uint32_t                        number of timers
+ * \return int pollable file descriptor or -1 on error.
+ *
+ */
+int init_runtime(linux_runtime_t* const pRuntime,
+                 state_machine_t* const pState_Machine[],
+                 uint32_t quantity,
+                 runtime_timer_t* const pTimers,
+                 uint32_t totalTimers)
+{
+  pRuntime->State_Machines = pState_Machine;
+  pRuntime->Quantity = quantity;
+  pRuntime->Timers = pTimers;
+  pRuntime->Total_Timers = totalTimers;
+  pRuntime->Armed = 0;
+  for(uint32_t index = 0; index < totalTimers; index++)
+  {
+    pTimers[index].Expiry = 0;
+  }
+
+  pRuntime->Event_Fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  pRuntime->Timer_Fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  pRuntime->Fd = epoll_create1(EPOLL_CLOEXEC);
+
+  if((pRuntime->Event_Fd >= 0) && (pRuntime->Timer_Fd >= 0) && (pRuntime->Fd >= 0))
+  {
+    struct epoll_event event = {0};
+    event.events = EPOLLIN;
+    event.data.fd = pRuntime->Event_Fd;
+    if(epoll_ctl(pRuntime->Fd, EPOLL_CTL_ADD, pRuntime->Event_Fd, &event) == 0)
+    {
+      event.data.fd = pRuntime->Timer_Fd;
+      if(epoll_ctl(pRuntime->Fd, EPOLL_CTL_ADD, pRuntime->Timer_Fd, &event) == 0)
+      {
+        return pRuntime->Fd;
+      }
+    }
+  }
+
+  close_runtime(pRuntime);
+  return -1;
+}
+
+/** \brief Close all the file descriptors of runtime.
+ *
+ * \param pRuntime linux_runtime_t* const   runtime
+ *
+ */
+void close_runtime(linux_runtime_t* const pRuntime)
+{
+  int* const pFds[] = {&pRuntime->Fd, &pRuntime->Event_Fd, &pRuntime->Timer_Fd};
+  for(uint32_t index = 0; index < sizeof(pFds)/sizeof(pFds[0]); index++)
+  {
+    if(*pFds[index] >= 0)
+    {
+      close(*pFds[index]);
+      *pFds[index] = -1;
+    }
+  }
+}
+
+/** \brief Post an event to state machine and wake up the dispatcher.
+ *  It is safe to call from any thread.
+ *
+ * \param pRuntime linux_runtime_t* const       runtime
+ * \param pState_Machine state_machine_t* const target state machine
+ * \param event uint32_t                        event to post
+ * \param pToken event_token_t* const           completion token, see post_event.
+ * \return bool false if state machine has already a pending event.
+ *
+ */
+bool runtime_post(linux_runtime_t* const pRuntime,
+                  state_machine_t* const pState_Machine,
+                  uint32_t event,
+                  event_token_t* const pToken)
+{
+  if(!post_event(pState_Machine, event, pToken))
+  {
+    return false;
+  }
+  signal_runtime(pRuntime);
+  return true;
+}
+
+/** \brief Post an event to state machine from signal handler and wake up the dispatcher.
+ *  It is async-signal-safe, see post_event_from_isr. errno of the interrupted thread is preserved.
+ *
+ * \param pRuntime linux_runtime_t* const       runtime
+ * \param pState_Machine state_machine_t* const target state machine
+ * \param event uint32_t                        event to post
+ * \param payload uint32_t                      payload of event, see post_event_from_isr.
+ * \return bool false if state machine has already a pending event or queue is full.
+ *
+ */
+bool runtime_post_from_signal(linux_runtime_t* const pRuntime,
+                              state_machine_t* const pState_Machine,
+                              uint32_t event,
+                              uint32_t payload)
+{
+  if(!post_event_from_isr(pState_Machine, event, payload))
+  {
+    return false;
+  }
+
+  const int error = errno;
+  signal_runtime(pRuntime);
+  errno = error;
+  return true;
+}
+
+/** \brief Start a one shot timer. It posts the event to state machine after timeout.
+ *  Starting a running timer restarts it. Call it only from the dispatcher thread, e.g. from state handlers.
+ *
+ * \param pRuntime linux_runtime_t* const       runtime
+ * \param timer uint32_t                        index of timer
+ * \param pState_Machine state_machine_t* const target state machine
+ * \param event uint32_t                        event to post on expiry
+ * \param milliseconds uint32_t                 timeout
+ *
+ */
+void start_timer(linux_runtime_t* const pRuntime,
+                 uint32_t timer,
+                 state_machine_t* const pState_Machine,
+                 uint32_t event,
+                 uint32_t milliseconds)
+{
+  runtime_timer_t* const pTimer = &pRuntime->Timers[timer];
+  pTimer->Machine = pState_Machine;
+  pTimer->Event = event;
+  pTimer->Expiry = get_time() + ((uint64_t)milliseconds * NANOSECONDS_PER_MILLISECOND);
+  arm_timer(pRuntime);
+}
+
+/** \brief Stop the timer. Call it only from the dispatcher thread.
+ *
+ * \param pRuntime linux_runtime_t* const   runtime
+ * \param timer uint32_t                    index of timer
+ *
+ */
+void stop_timer(linux_runtime_t* const pRuntime, uint32_t timer)
+{
+  pRuntime->Timers[timer].Expiry = 0;
+  arm_timer(pRuntime);
+}
+
+/** \brief Dispatch the posted events and events of expired timers.
+ *  Call it when the runtime descriptor is readable.
+ *  If dispatch_event returns BUDGET_EXHAUSTED, descriptor is kept readable for the next call.
+ *
+ * \param pRuntime linux_runtime_t* const   runtime
+ * \return state_machine_result_t           result of dispatch_event
+ *
+ */
+state_machine_result_t runtime_dispatch(linux_runtime_t* const pRuntime
+#if STATE_MACHINE_LOGGER
+                                        ,state_machine_event_logger event_logger
+                                        ,state_machine_result_logger result_logger
+#endif // STATE_MACHINE_LOGGER
+                                        )
+{
+  uint64_t count;
+  state_machine_result_t result;
+  uint32_t blocked;
+
+  // Clear the readiness of both descriptors. Nonblocking reads fail if nothing is pending.
+  (void)!read(pRuntime->Event_Fd, &count, sizeof(count));
+  if(read(pRuntime->Timer_Fd, &count, sizeof(count)) == sizeof(count))
+  {
+    pRuntime->Armed = 0;    // One shot timerfd is disarmed after expiry.
+  }
+
+  do
+  {
+    blocked = fire_timers(pRuntime);
+    result = dispatch_event(pRuntime->State_Machines, pRuntime->Quantity
+#if STATE_MACHINE_LOGGER
+                            ,event_logger, result_logger
+#endif // STATE_MACHINE_LOGGER
+                            );
+    // Expired timers of busy state machines are posted once all the events are handled.
+  }while((blocked != 0) && (result == EVENT_HANDLED));
+
+  if(result == BUDGET_EXHAUSTED)
+  {
+    signal_runtime(pRuntime);
+  }
+
+  arm_timer(pRuntime);
+  return result;
+}
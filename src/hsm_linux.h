@@ -0,0 +1,93 @@
+/**
+ * \file
+ * \brief Linux runtime of state machine dispatcher.
+ *
+ *  The runtime exposes a single pollable file descriptor. It becomes readable when an event
+ *  is posted using runtime_post (eventfd) or when the earliest running timer expires (timerfd).
+ *  Add the descriptor to an existing epoll/poll loop and call runtime_dispatch when it is readable.
+ *  No thread is created by the runtime.
+
+ * \author  Nandkishor Biradar
+ * \date    19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+#ifndef HSM_LINUX_H
+#define HSM_LINUX_H
+
+/*
+ *  --------------------- STRUCTURE ---------------------
+ */
+
+//! One shot timer that posts an event to state machine on expiry.
+typedef struct
+{
+  state_machine_t* Machine;   //!< Target state machine
+  uint32_t Event;             //!< Event to post on expiry
+  uint64_t Expiry;            //!< Expiry time in nanoseconds of CLOCK_MONOTONIC. 0: timer is stopped.
+}runtime_timer_t;
+
+//! Linux runtime of dispatcher
+typedef struct
+{
+  int Fd;                               //!< Pollable file descriptor (epoll of Event_Fd and Timer_Fd)
+  int Event_Fd;                         //!< eventfd signalled by runtime_post
+  int Timer_Fd;                         //!< timerfd armed with the earliest timer expiry
+  state_machine_t* const* State_Machines; //!< Array of state machines in priority order
+  uint32_t Quantity;                    //!< Number of state machines
+  runtime_timer_t* Timers;              //!< User provided timers
+  uint32_t Total_Timers;                //!< Number of timers
+  uint64_t Armed;                       //!< Expiry time the Timer_Fd is armed with. 0: disarmed.
+}linux_runtime_t;
+
+/*
+ *  --------------------- EXPORTED FUNCTION ---------------------
+ */
+
+#ifdef __cplusplus
+extern "C"  {
+#endif // __cplusplus
+
+extern int init_runtime(linux_runtime_t* const pRuntime,
+                        state_machine_t* const pState_Machine[],
+                        uint32_t quantity,
+                        runtime_timer_t* const pTimers,
+                        uint32_t totalTimers);
+
+extern void close_runtime(linux_runtime_t* const pRuntime);
+
+extern bool runtime_post(linux_runtime_t* const pRuntime,
+                         state_machine_t* const pState_Machine,
+                         uint32_t event,
+                         event_token_t* const pToken);
+
+extern bool runtime_post_from_signal(linux_runtime_t* const pRuntime,
+                                     state_machine_t* const pState_Machine,
+                                     uint32_t event,
+                                     uint32_t payload);
+
+extern void start_timer(linux_runtime_t* const pRuntime,
+                        uint32_t timer,
+                        state_machine_t* const pState_Machine,
+                        uint32_t event,
+                        uint32_t milliseconds);
+
+extern void stop_timer(linux_runtime_t* const pRuntime, uint32_t timer);
+
+extern state_machine_result_t runtime_dispatch(linux_runtime_t* const pRuntime
+#if STATE_MACHINE_LOGGER
+                                               ,state_machine_event_logger event_logger
+                                               ,state_machine_result_logger result_logger
+#endif // STATE_MACHINE_LOGGER
+                                               );
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // HSM_LINUX_H
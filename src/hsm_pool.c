@@ -0,0 +1,367 @@
+/**
+ * \file
+ * \brief Pool of state machine instances.
+
+ * \author  Nandkishor Biradar
+ * \date    19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+/*
+ *  --------------------- INCLUDE FILES ---------------------
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "hsm.h"
+#include "hsm_post.h"
+#include "hsm_pool.h"
+
+#if !defined(HSM_WAIT_YIELD) && (defined(__unix__) || defined(__APPLE__))
+#include <sched.h>
+#endif
+
+/*
+ *  --------------------- DEFINITION ---------------------
+ */
+
+#if defined(__GNUC__)
+#define HSM_FULL_FENCE()    __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#elif !defined(HSM_FULL_FENCE)
+// Without a full barrier destroy_machine can't wait for the posts in progress on the slot.
+#error "Define HSM_FULL_FENCE() using the full memory barrier of the target"
+#endif
+
+#ifndef HSM_WAIT_YIELD
+#if defined(__unix__) || defined(__APPLE__)
+#define HSM_WAIT_YIELD()    sched_yield()   //!< Yield the CPU while waiting for the posts on the slot
+#else
+#define HSM_WAIT_YIELD()                    //!< Busy waiting, define it to yield on the target
+#endif
+#endif // HSM_WAIT_YIELD
+
+#if HSM_STATE_CENSUS || HSM_STATE_INDEX
+//! State of a destroyed slot while the pool is reset. Live instance never has this state.
+#if HSM_COMPACT_STATE
+#define FREE_SLOT_STATE(pPool)    UINT16_MAX
+#else
+#define FREE_SLOT_STATE(pPool)    ((const state_t*)(const void*)(pPool))
+#endif // HSM_COMPACT_STATE
+#endif // HSM_STATE_CENSUS || HSM_STATE_INDEX
+
+/*
+ *  --------------------- FUNCTION BODY ---------------------
+ */
+
+//! Returns the address of slot.
+static inline uint8_t* get_slot(const machine_pool_t* const pPool, uint32_t index)
+{
+  return pPool->Memory + ((size_t)index * pPool->Slot_Size);
+}
+
+//! Clear the slot and set the initial state of instance in it.
+static inline void init_slot(uint8_t* const pSlot, size_t size, const state_t* const pInitial_State)
+{
+  memset(pSlot, 0, size);
+  set_state((state_machine_t*)(void*)pSlot, pInitial_State);
+#if HSM_STATE_CENSUS
+  census_add((state_machine_t*)(void*)pSlot);
+#endif // HSM_STATE_CENSUS
+#if HSM_STATE_INDEX
+  index_add((state_machine_t*)(void*)pSlot);
+#endif // HSM_STATE_INDEX
+}
+
+//! Invalidate the handles of slot and wait until the posts in progress on the slot are completed.
+static inline void retire_slot(const machine_pool_t* const pPool, uint32_t index)
+{
+  machine_slot_t* const pSlot = &pPool->Slot[index];
+  HSM_STORE_RELEASE(&pSlot->Generation, pSlot->Generation + 1);
+  // Orders the increment of generation with the check of posters, see post_event_to_handle.
+  // A poster that has not announced itself yet finds the new generation and doesn't touch the slot.
+  HSM_FULL_FENCE();
+  while(HSM_LOAD_ACQUIRE(&pSlot->Posters) != 0)
+  {
+    HSM_WAIT_YIELD();
+  }
+}
+
+#if HSM_STATE_CENSUS || HSM_STATE_INDEX
+/** \brief Remove the live instances of pool from the census and index.
+ *  Destroyed slots are marked through the free list first, as they store only the index of next free slot.
+ */
+static void remove_live_machines(const machine_pool_t* const pPool)
+{
+  for(uint32_t index = pPool->Free; index != POOL_END;)
+  {
+    state_machine_t* const pSlot = get_pool_machine(pPool, index);
+    memcpy(&index, pSlot, sizeof(index));
+    pSlot->State = FREE_SLOT_STATE(pPool);
+  }
+
+  for(uint32_t index = 0; index < pPool->Unused; index++)
+  {
+    state_machine_t* const pState_Machine = get_pool_machine(pPool, index);
+    if(pState_Machine->State != FREE_SLOT_STATE(pPool))
+    {
+#if HSM_STATE_CENSUS
+      census_remove(pState_Machine);
+#endif // HSM_STATE_CENSUS
+#if HSM_STATE_INDEX
+      index_remove(pState_Machine);
+#endif // HSM_STATE_INDEX
+    }
+  }
+}
+#endif // HSM_STATE_CENSUS || HSM_STATE_INDEX
+
+/** \brief Initialize the pool of state machine instances.
+ *
+ * \param pPool machine_pool_t* const   pool to initialize
+ * \param pMemory void* const           memory of MACHINE_POOL_SIZE(size, capacity) bytes, aligned to HSM_POOL_CACHE_LINE
+ * \param size size_t                   size of user derived state machine
+ * \param capacity uint32_t             maximum number of instances
+ * \return bool false if memory is not aligned or size is smaller than state_machine_t.
+ *
+ */
+bool init_machine_pool(machine_pool_t* const pPool,
+                       void* const pMemory,
+                       size_t size,
+                       uint32_t capacity)
+{
+  if((((uintptr_t)pMemory % HSM_POOL_CACHE_LINE) != 0)
+     || (size < sizeof(state_machine_t))
+     || (capacity == POOL_END))
+  {
+    return false;
+  }
+
+  pPool->Memory = (uint8_t*)pMemory;
+  pPool->Slot_Size = MACHINE_SLOT_SIZE(size);
+  pPool->Capacity = capacity;
+  pPool->Unused = 0;
+  pPool->Free = POOL_END;
+  pPool->Used = 0;
+  pPool->Slot = NULL;
+  return true;
+}
+
+/** \brief Enable the handles of instances. Call it before creating any instance.
+ *
+ * \param pPool machine_pool_t* const     pool
+ * \param pSlots machine_slot_t* const    array of handle state, one per slot of pool
+ * \return bool false if capacity of pool is too large for the index bits of handle.
+ *
+ */
+bool enable_machine_handles(machine_pool_t* const pPool, machine_slot_t* const pSlots)
+{
+#if !HSM_POOL_HANDLE_64
+  // Index of INVALID_HANDLE must be out of range.
+  if(pPool->Capacity > HANDLE_INDEX_MASK)
+  {
+    return false;
+  }
+#endif // !HSM_POOL_HANDLE_64
+
+  memset(pSlots, 0, (size_t)pPool->Capacity * sizeof(pSlots[0]));
+  pPool->Slot = pSlots;
+  return true;
+}
+
+/** \brief Destroy all the instances of pool at once.
+ *  The live instances are removed from the census and index, in O(slots ever allocated).
+ *
+ * \param pPool machine_pool_t* const   pool
+ *
+ */
+void reset_machine_pool(machine_pool_t* const pPool)
+{
+#if HSM_STATE_CENSUS || HSM_STATE_INDEX
+  remove_live_machines(pPool);
+#endif // HSM_STATE_CENSUS || HSM_STATE_INDEX
+
+  if(pPool->Slot != NULL)
+  {
+    // Invalidate the handles of all the slots that are ever allocated.
+    for(uint32_t index = 0; index < pPool->Unused; index++)
+    {
+      retire_slot(pPool, index);
+    }
+  }
+
+  pPool->Unused = 0;
+  pPool->Free = POOL_END;
+  pPool->Used = 0;
+}
+
+/** \brief Create an instance of state machine. The instance is zero initialized
+ *  and its state is set to the initial state, without calling the entry action.
+ *
+ * \param pPool machine_pool_t* const           pool
+ * \param pInitial_State const state_t* const   initial state
+ * \return state_machine_t*                     new instance or NULL if pool is full.
+ *
+ */
+state_machine_t* create_machine(machine_pool_t* const pPool, const state_t* const pInitial_State)
+{
+  uint32_t index;
+
+  if(pPool->Free != POOL_END)
+  {
+    // Destroyed slot stores the index of next free slot.
+    index = pPool->Free;
+    memcpy(&pPool->Free, get_slot(pPool, index), sizeof(pPool->Free));
+  }
+  else if(pPool->Unused < pPool->Capacity)
+  {
+    index = pPool->Unused++;
+  }
+  else
+  {
+    return NULL;
+  }
+
+  uint8_t* const pSlot = get_slot(pPool, index);
+  init_slot(pSlot, pPool->Slot_Size, pInitial_State);
+  pPool->Used++;
+  return (state_machine_t*)(void*)pSlot;
+}
+
+/** \brief Create instances of state machine in bulk. Destroyed slots are reused first,
+ *  then the never used slots are cleared with a single memset.
+ *
+ * \param pPool machine_pool_t* const           pool
+ * \param pState_Machine[] state_machine_t*     array to store the new instances
+ * \param quantity uint32_t                     number of instances to create
+ * \param pInitial_State const state_t* const   initial state
+ * \return uint32_t                             number of instances created, less than quantity if pool is full.
+ *
+ */
+uint32_t create_machines(machine_pool_t* const pPool,
+                         state_machine_t* pState_Machine[],
+                         uint32_t quantity,
+                         const state_t* const pInitial_State)
+{
+  uint32_t created = 0;
+
+  while((created < quantity) && (pPool->Free != POOL_END))
+  {
+    pState_Machine[created++] = create_machine(pPool, pInitial_State);
+  }
+
+  uint32_t remaining = pPool->Capacity - pPool->Unused;
+  if(remaining > (quantity - created))
+  {
+    remaining = quantity - created;
+  }
+
+  uint8_t* pSlot = get_slot(pPool, pPool->Unused);
+  memset(pSlot, 0, (size_t)remaining * pPool->Slot_Size);
+  for(uint32_t count = 0; count < remaining; count++)
+  {
+    set_state((state_machine_t*)(void*)pSlot, pInitial_State);
+#if HSM_STATE_CENSUS
+    census_add((state_machine_t*)(void*)pSlot);
+#endif // HSM_STATE_CENSUS
+#if HSM_STATE_INDEX
+    index_add((state_machine_t*)(void*)pSlot);
+#endif // HSM_STATE_INDEX
+    pState_Machine[created++] = (state_machine_t*)(void*)pSlot;
+    pSlot += pPool->Slot_Size;
+  }
+
+  pPool->Unused += remaining;
+  pPool->Used += remaining;
+  return created;
+}
+
+/** \brief Destroy an instance of state machine and release its slot for reuse.
+ *  Exit action of the current state is not called. Handles of the instance become invalid.
+ *  The instance is removed from the census and index.
+ *  It waits for the post_event_to_handle in progress on the instance, hence don't call it
+ *  from the dispatcher of an instance whose queue blocks the producers on overflow.
+ *
+ * \param pPool machine_pool_t* const           pool
+ * \param pState_Machine state_machine_t* const instance created from the pool
+ *
+ */
+void destroy_machine(machine_pool_t* const pPool, state_machine_t* const pState_Machine)
+{
+  const uint32_t index = get_pool_index(pPool, pState_Machine);
+#if HSM_STATE_CENSUS
+  census_remove(pState_Machine);
+#endif // HSM_STATE_CENSUS
+#if HSM_STATE_INDEX
+  index_remove(pState_Machine);
+#endif // HSM_STATE_INDEX
+  if(pPool->Slot != NULL)
+  {
+    retire_slot(pPool, index);
+  }
+  // No poster can access the instance now, its memory stores the index of next free slot.
+  memcpy(pState_Machine, &pPool->Free, sizeof(pPool->Free));
+  pPool->Free = index;
+  pPool->Used--;
+}
+
+/** \brief Destroy the instances of state machine in bulk.
+ *
+ * \param pPool machine_pool_t* const             pool
+ * \param pState_Machine[] state_machine_t* const instances created from the pool
+ * \param quantity uint32_t                       number of instances
+ *
+ */
+void destroy_machines(machine_pool_t* const pPool,
+                      state_machine_t* const pState_Machine[],
+                      uint32_t quantity)
+{
+  for(uint32_t index = 0; index < quantity; index++)
+  {
+    destroy_machine(pPool, pState_Machine[index]);
+  }
+}
+
+/** \brief Post an event to the instance addressed by handle. It is safe to call from any thread,
+ *  also while the instance is destroyed. The post is announced in the slot before the handle is
+ *  resolved, so that destroy_machine waits for it, and a post that resolves the handle after the
+ *  destroy is rejected. Hence the event is never written to a destroyed or reused instance.
+ *
+ * \param pPool const machine_pool_t* const   pool with handles enabled
+ * \param handle machine_handle_t             handle of instance
+ * \param event uint32_t                      event to post
+ * \param pToken event_token_t* const         completion token, see post_event.
+ * \return bool false if instance is destroyed or it has already a pending event.
+ *
+ */
+bool post_event_to_handle(const machine_pool_t* const pPool,
+                          machine_handle_t handle,
+                          uint32_t event,
+                          event_token_t* const pToken)
+{
+  const uint32_t index = (uint32_t)(handle & HANDLE_INDEX_MASK);
+  if(index >= pPool->Capacity)
+  {
+    return false;
+  }
+
+  machine_slot_t* const pSlot = &pPool->Slot[index];
+  // Orders the announcement with the check of generation, see retire_slot.
+  HSM_FETCH_ADD(&pSlot->Posters, 1);
+  HSM_FULL_FENCE();
+
+  state_machine_t* const pState_Machine = resolve_machine(pPool, handle);
+  const bool posted = (pState_Machine != NULL) && post_event(pState_Machine, event, pToken);
+
+  // Orders the post with the reuse of slot after destroy_machine finds no poster.
+  HSM_FULL_FENCE();
+  HSM_FETCH_ADD(&pSlot->Posters, (uint32_t)-1);
+  return posted;
+}
@@ -0,0 +1,216 @@
+/**
+ * \file
+ * \brief Pool of state machine instances.
+ *
+ *  The pool allocates the instances of a user derived state machine (state_machine_t
+ *  as the first member) from a user provided memory. Each instance occupies a slot
+ *  rounded up to the cache line, so that instances dispatched from different threads
+ *  never share a cache line. Destroyed slots are reused through an intrusive free list,
+ *  never used slots are carved in bulk. The pool doesn't use heap and never fragments.
+ *  It is not thread safe, create and destroy the instances from one thread.
+ *
+ *  Handles address the instances across threads. A handle packs the index of slot and
+ *  the generation of slot, which is incremented when the instance is destroyed. Resolving
+ *  the handle of a destroyed instance returns NULL instead of a dangling pointer.
+ *  Events can be posted to a handle while the instance is destroyed, destroy_machine
+ *  waits for the posts in progress on the slot before it reuses the memory of instance.
+ *  On targets other than GCC/Clang, define HSM_FULL_FENCE() and the atomic macros of hsm.h.
+
+ * \author  Nandkishor Biradar
+ * \date    19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+#ifndef HSM_POOL_H
+#define HSM_POOL_H
+
+#include <stddef.h>
+
+/*
+ *  --------------------- DEFINITION ---------------------
+ */
+
+#ifndef HSM_POOL_CACHE_LINE
+//! Size of cache line in bytes. Slot size and memory of pool are aligned to it.
+#define HSM_POOL_CACHE_LINE     64
+#endif // HSM_POOL_CACHE_LINE
+
+//! Size of slot for an instance of the given size.
+#define MACHINE_SLOT_SIZE(size)   \
+  (((size_t)(size) + HSM_POOL_CACHE_LINE - 1) & ~(size_t)(HSM_POOL_CACHE_LINE - 1))
+
+//! Size of memory required for the pool of given number of instances.
+#define MACHINE_POOL_SIZE(size, capacity)   (MACHINE_SLOT_SIZE(size) * (size_t)(capacity))
+
+//! End of free list
+#define POOL_END      UINT32_MAX
+
+#ifndef HSM_POOL_HANDLE_64
+//! 0: 32-bit handles, 1: 64-bit handles
+#define HSM_POOL_HANDLE_64      0
+#endif // HSM_POOL_HANDLE_64
+
+#if HSM_POOL_HANDLE_64
+//! Number of bits of slot index in the handle. Remaining bits store the generation.
+#define HANDLE_INDEX_BITS     32
+#else
+#ifndef HSM_POOL_INDEX_BITS
+//! Number of bits of slot index in 32-bit handle. Remaining bits store the generation.
+//! With 20 bits of index, the generation wraps after 4096 reuses of a slot and a stale handle
+//! held for that long resolves to the new instance. Use HSM_POOL_HANDLE_64 if handles live longer.
+#define HSM_POOL_INDEX_BITS   20
+#endif // HSM_POOL_INDEX_BITS
+#define HANDLE_INDEX_BITS     HSM_POOL_INDEX_BITS
+#endif // HSM_POOL_HANDLE_64
+
+//! Mask of slot index in the handle
+#define HANDLE_INDEX_MASK     (((machine_handle_t)1 << HANDLE_INDEX_BITS) - 1)
+
+//! Handle that never resolves to an instance.
+#define INVALID_HANDLE        ((machine_handle_t)-1)
+
+/*
+ *  --------------------- TYPE ---------------------
+ */
+
+#if HSM_POOL_HANDLE_64
+typedef uint64_t machine_handle_t;    //!< 32-bit slot index and 32-bit generation
+#else
+typedef uint32_t machine_handle_t;    //!< Slot index and truncated generation
+#endif // HSM_POOL_HANDLE_64
+
+/*
+ *  --------------------- STRUCTURE ---------------------
+ */
+
+//! Handle state of a slot
+typedef struct
+{
+  uint32_t Generation;      //!< Incremented when the instance in the slot is destroyed
+  uint32_t Posters;         //!< Number of post_event_to_handle in progress on the slot
+}machine_slot_t;
+
+//! Pool of state machine instances
+typedef struct
+{
+  uint8_t* Memory;          //!< User provided memory, aligned to HSM_POOL_CACHE_LINE
+  size_t Slot_Size;         //!< Size of slot, multiple of HSM_POOL_CACHE_LINE
+  uint32_t Capacity;        //!< Total number of slots
+  uint32_t Unused;          //!< Index of first slot that is never allocated
+  uint32_t Free;            //!< Head of the list of destroyed slots, POOL_END if empty
+  uint32_t Used;            //!< Number of live instances
+  machine_slot_t* Slot;     //!< Handle state of each slot, NULL if handles are not enabled
+}machine_pool_t;
+
+/*
+ *  --------------------- EXPORTED FUNCTION ---------------------
+ */
+
+#ifdef __cplusplus
+extern "C"  {
+#endif // __cplusplus
+
+extern bool init_machine_pool(machine_pool_t* const pPool,
+                              void* const pMemory,
+                              size_t size,
+                              uint32_t capacity);
+
+extern void reset_machine_pool(machine_pool_t* const pPool);
+
+extern bool enable_machine_handles(machine_pool_t* const pPool, machine_slot_t* const pSlots);
+
+extern state_machine_t* create_machine(machine_pool_t* const pPool, const state_t* const pInitial_State);
+
+extern uint32_t create_machines(machine_pool_t* const pPool,
+                                state_machine_t* pState_Machine[],
+                                uint32_t quantity,
+                                const state_t* const pInitial_State);
+
+extern void destroy_machine(machine_pool_t* const pPool, state_machine_t* const pState_Machine);
+
+extern void destroy_machines(machine_pool_t* const pPool,
+                             state_machine_t* const pState_Machine[],
+                             uint32_t quantity);
+
+extern bool post_event_to_handle(const machine_pool_t* const pPool,
+                                 machine_handle_t handle,
+                                 uint32_t event,
+                                 event_token_t* const pToken);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+/*
+ *  --------------------- Inline functions ---------------------
+ */
+
+/** \brief Get the instance in the given slot of pool.
+ *
+ * \param pPool const machine_pool_t* const   pool
+ * \param index uint32_t                      index of slot
+ * \return state_machine_t*                   instance in the slot
+ *
+ */
+static inline state_machine_t* get_pool_machine(const machine_pool_t* const pPool, uint32_t index)
+{
+  return (state_machine_t*)(void*)(pPool->Memory + ((size_t)index * pPool->Slot_Size));
+}
+
+/** \brief Get the index of slot of an instance allocated from the pool.
+ *
+ * \param pPool const machine_pool_t* const           pool
+ * \param pState_Machine const state_machine_t* const instance
+ * \return uint32_t                                   index of slot
+ *
+ */
+static inline uint32_t get_pool_index(const machine_pool_t* const pPool,
+                                      const state_machine_t* const pState_Machine)
+{
+  return (uint32_t)(((const uint8_t*)pState_Machine - pPool->Memory) / pPool->Slot_Size);
+}
+
+/** \brief Get the handle of an instance. Handles must be enabled in the pool.
+ *
+ * \param pPool const machine_pool_t* const           pool
+ * \param pState_Machine const state_machine_t* const instance created from the pool
+ * \return machine_handle_t                           handle of instance
+ *
+ */
+static inline machine_handle_t get_machine_handle(const machine_pool_t* const pPool,
+                                                  const state_machine_t* const pState_Machine)
+{
+  const uint32_t index = get_pool_index(pPool, pState_Machine);
+  return (machine_handle_t)index | ((machine_handle_t)pPool->Slot[index].Generation << HANDLE_INDEX_BITS);
+}
+
+/** \brief Resolve the handle to instance in O(1). It is safe to call from any thread.
+ *
+ * \param pPool const machine_pool_t* const   pool with handles enabled
+ * \param handle machine_handle_t             handle of instance
+ * \return state_machine_t*                   instance or NULL if it is destroyed.
+ *
+ */
+static inline state_machine_t* resolve_machine(const machine_pool_t* const pPool, machine_handle_t handle)
+{
+  const uint32_t index = (uint32_t)(handle & HANDLE_INDEX_MASK);
+  if(index >= pPool->Capacity)
+  {
+    return NULL;
+  }
+
+  // Generation in the handle is truncated to the remaining bits of handle.
+  const machine_handle_t generation = (machine_handle_t)HSM_LOAD_ACQUIRE(&pPool->Slot[index].Generation);
+  if((machine_handle_t)(generation << HANDLE_INDEX_BITS) != (handle & ~HANDLE_INDEX_MASK))
+  {
+    return NULL;
+  }
+  return get_pool_machine(pPool, index);
+}
+
+#endif // HSM_POOL_H
@@ -0,0 +1,905 @@
+/**
+ * \file
+ * \brief Posting events to state machines from other threads.
+
+ * \author  Nandkishor Biradar
+ * \date    19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+/*
+ *  --------------------- INCLUDE FILES ---------------------
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE       // syscall in strict ISO C mode
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "hsm.h"
+#include "hsm_post.h"
+
+#if HSM_EVENT_RECORDER
+#include "hsm_record.h"
+#endif // HSM_EVENT_RECORDER
+
+#if (HSM_EVENT_COMPLETION || HSM_EVENT_QUEUE) && defined(__linux__)
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+
+#if HSM_EVENT_COMPLETION && !defined(__linux__) && !defined(HSM_WAIT_YIELD) \
+    && (defined(__unix__) || defined(__APPLE__))
+#include <sched.h>
+#endif
+
+/*
+ *  --------------------- DEFINITION ---------------------
+ */
+
+#if HSM_EVENT_COMPLETION
+#define TOKEN_PENDING     0u    //!< Event is not yet processed.
+#define TOKEN_COMPLETED   1u    //!< Run to completion step of event is completed.
+#define TOKEN_WAITING     2u    //!< Event is not yet processed and producer is blocked on token.
+
+#if !defined(__linux__) && !defined(HSM_WAIT_YIELD)
+#if defined(__unix__) || defined(__APPLE__)
+#define HSM_WAIT_YIELD()    sched_yield()   //!< Yield the CPU while polling the token
+#else
+#define HSM_WAIT_YIELD()                    //!< Busy polling, define it to yield on the target
+#endif
+#endif // !defined(__linux__) && !defined(HSM_WAIT_YIELD)
+#endif // HSM_EVENT_COMPLETION
+
+/*
+ *  --------------------- GLOBAL VARIABLE ---------------------
+ */
+
+#if HSM_EVENT_COMPLETION
+event_token_t Anonymous_Token;
+#endif // HSM_EVENT_COMPLETION
+
+/*
+ *  --------------------- FUNCTION BODY ---------------------
+ */
+
+#if HSM_EVENT_RECORDER
+/** \brief Records the event accepted for the state machine, if a recorder is attached to it.
+ */
+static inline void record_post(const state_machine_t* const pState_Machine, uint32_t event)
+{
+  event_recorder_t* const pRecorder = pState_Machine->Recorder;
+  if(pRecorder != NULL)
+  {
+    record_event(pRecorder, pState_Machine->Record_Index, event);
+  }
+}
+#endif // HSM_EVENT_RECORDER
+
+#if HSM_EVENT_QUEUE
+//! Atomically set the bits and return the previous value.
+static inline uint32_t fetch_or(uint32_t* const pVariable, uint32_t bits)
+{
+  uint32_t value = HSM_LOAD_ACQUIRE(pVariable);
+  while(!HSM_COMPARE_EXCHANGE(pVariable, &value, value | bits));
+  return value;
+}
+
+//! Atomically clear the bits.
+static inline void clear_bits(uint32_t* const pVariable, uint32_t bits)
+{
+  uint32_t value = HSM_LOAD_ACQUIRE(pVariable);
+  while(!HSM_COMPARE_EXCHANGE(pVariable, &value, value & ~bits));
+}
+
+#if HSM_QUEUE_LANES > 1
+//! Returns the highest priority lane in the non zero bitmask of lanes.
+static inline uint32_t first_lane(uint32_t lanes)
+{
+#if defined(__GNUC__)
+  return (uint32_t)__builtin_ctz(lanes);
+#else
+  uint32_t lane = 0;
+  while((lanes & 1) == 0)
+  {
+    lanes >>= 1;
+    lane++;
+  }
+  return lane;
+#endif
+}
+#endif // HSM_QUEUE_LANES > 1
+
+/** \brief Store the event in the free cell of lane.
+ *  Producers reserve the cell by advancing the tail, and publish it by updating the
+ *  sequence of cell. It is safe to call from multiple threads.
+ *  The coalesced event is marked in pQueued after the cell is reserved and before it is
+ *  published, hence a marked event is always delivered and the dispatcher unmarks it only
+ *  after the event is fetched.
+ *
+ * \return bool false if lane is full.
+ */
+static bool enqueue_event(event_lane_t* const pLane,
+                          uint32_t event,
+                          uint32_t payload,
+                          event_token_t* const pToken,
+                          uint32_t* const pQueued,
+                          uint32_t coalesced)
+{
+  queued_event_t* pCell;
+  uint32_t position = HSM_LOAD_ACQUIRE(&pLane->Tail);
+
+  while(1)
+  {
+    pCell = &pLane->Buffer[position & pLane->Mask];
+    const int32_t difference = (int32_t)(HSM_LOAD_ACQUIRE(&pCell->Sequence) - position);
+    if(difference == 0)
+    {
+      // Cell is free, reserve it. On failure, position is updated with the current tail.
+      if(HSM_COMPARE_EXCHANGE(&pLane->Tail, &position, position + 1))
+      {
+        break;
+      }
+    }
+    else if(difference < 0)
+    {
+      return false;   // Dispatcher has not yet fetched the event from this cell.
+    }
+    else
+    {
+      position = HSM_LOAD_ACQUIRE(&pLane->Tail);   // Another producer reserved the cell.
+    }
+  }
+
+  if(coalesced != 0)
+  {
+    fetch_or(pQueued, coalesced);
+  }
+  pCell->Event = event;
+  pCell->Payload = payload;
+#if HSM_EVENT_COMPLETION
+  // Token is reset only when the event is sure to be queued, a rejected post doesn't modify it.
+  if(pToken != NULL)
+  {
+    pToken->Status = TOKEN_PENDING;
+  }
+  pCell->Token = pToken;
+#else
+  (void)pToken;
+#endif // HSM_EVENT_COMPLETION
+  HSM_STORE_RELEASE(&pCell->Sequence, position + 1);
+  return true;
+}
+
+/** \brief Remove the oldest event from the lane. Called by the dispatcher and by the
+ *  producers that drop the oldest event of full lane, hence the head is advanced atomically.
+ *
+ * \return bool false if lane is empty.
+ */
+static bool dequeue_event(event_lane_t* const pLane, queued_event_t* const pEvent)
+{
+  queued_event_t* pCell;
+  uint32_t position = HSM_LOAD_ACQUIRE(&pLane->Head);
+
+  while(1)
+  {
+    pCell = &pLane->Buffer[position & pLane->Mask];
+    const int32_t difference = (int32_t)(HSM_LOAD_ACQUIRE(&pCell->Sequence) - (position + 1));
+    if(difference == 0)
+    {
+      // Cell is published, claim it. On failure, position is updated with the current head.
+      if(HSM_COMPARE_EXCHANGE(&pLane->Head, &position, position + 1))
+      {
+        break;
+      }
+    }
+    else if(difference < 0)
+    {
+      return false;   // No event is published in this cell.
+    }
+    else
+    {
+      position = HSM_LOAD_ACQUIRE(&pLane->Head);   // Another thread claimed the cell.
+    }
+  }
+
+  *pEvent = *pCell;
+  // Release the cell for producers.
+  HSM_STORE_RELEASE(&pCell->Sequence, position + pLane->Mask + 1);
+  return true;
+}
+
+//! Returns the number of events in all the lanes of queue.
+static uint32_t queue_depth(const event_queue_t* const pQueue)
+{
+  uint32_t depth = 0;
+  for(uint32_t lane = 0; lane < HSM_QUEUE_LANES; lane++)
+  {
+    depth += HSM_LOAD_ACQUIRE(&pQueue->Lane[lane].Tail) - HSM_LOAD_ACQUIRE(&pQueue->Lane[lane].Head);
+  }
+  return depth;
+}
+
+/** \brief Update the high water mark after an event is queued and assert the backpressure
+ *  if the queue depth reaches the high threshold. Backpressure is not evaluated for events
+ *  posted from interrupt, as it may call the user handler.
+ */
+static void update_depth(event_queue_t* const pQueue, bool fromIsr)
+{
+  const uint32_t depth = queue_depth(pQueue);
+  uint32_t highWater = HSM_LOAD_ACQUIRE(&pQueue->High_Water);
+
+  while((depth > highWater) && !HSM_COMPARE_EXCHANGE(&pQueue->High_Water, &highWater, depth));
+
+  if(!fromIsr && (pQueue->High_Threshold != 0) && (depth >= pQueue->High_Threshold)
+     && (HSM_LOAD_ACQUIRE(&pQueue->Backpressure) == 0))
+  {
+    uint32_t expected = 0;
+    if(HSM_COMPARE_EXCHANGE(&pQueue->Backpressure, &expected, 1) && (pQueue->Backpressure_Handler != NULL))
+    {
+      pQueue->Backpressure_Handler(pQueue, true);
+    }
+  }
+}
+
+/** \brief Release the backpressure after an event is fetched, if the queue depth
+ *  drops to the low threshold. Called only by the dispatcher.
+ */
+static void release_backpressure(event_queue_t* const pQueue)
+{
+  if((HSM_LOAD_ACQUIRE(&pQueue->Backpressure) != 0) && (queue_depth(pQueue) <= pQueue->Low_Threshold))
+  {
+    uint32_t expected = 1;
+    if(HSM_COMPARE_EXCHANGE(&pQueue->Backpressure, &expected, 0) && (pQueue->Backpressure_Handler != NULL))
+    {
+      pQueue->Backpressure_Handler(pQueue, false);
+    }
+  }
+}
+
+/** \brief Drop the oldest event of full lane. The completion token of dropped event
+ *  is resolved with EVENT_UN_HANDLED.
+ */
+static void drop_event(event_queue_t* const pQueue, event_lane_t* const pLane)
+{
+  queued_event_t cell;
+
+  if(!dequeue_event(pLane, &cell))
+  {
+    return;   // Dispatcher has fetched the event meanwhile.
+  }
+
+  HSM_FETCH_ADD(&pQueue->Dropped, 1);
+  if((cell.Event < MAX_RULE_EVENTS)
+     && (((pQueue->Drop_Duplicate | pQueue->Keep_Latest) & ((uint32_t)1 << cell.Event)) != 0))
+  {
+    clear_bits(&pQueue->Queued, (uint32_t)1 << cell.Event);
+  }
+#if HSM_EVENT_COMPLETION
+  if(cell.Token != NULL)
+  {
+    resolve_event_token(cell.Token, EVENT_UN_HANDLED);
+  }
+#endif // HSM_EVENT_COMPLETION
+}
+
+#if defined(__linux__)
+/** \brief Block the producer until the dispatcher fetches an event from the full lane
+ *  or the timeout of OVERFLOW_BLOCK policy expires.
+ *
+ * \param pDeadline uint64_t* const  monotonic time in nanoseconds to give up, 0 on first call.
+ * \return bool false if timeout is expired.
+ */
+static bool wait_for_room(event_queue_t* const pQueue,
+                          event_lane_t* const pLane,
+                          uint64_t* const pDeadline)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  const uint64_t time = ((uint64_t)now.tv_sec * 1000000000u) + (uint64_t)now.tv_nsec;
+
+  if(*pDeadline == 0)
+  {
+    *pDeadline = time + ((uint64_t)pQueue->Timeout * 1000000u);
+  }
+  if(time >= *pDeadline)
+  {
+    return false;
+  }
+
+  const uint64_t remaining = *pDeadline - time;
+  const struct timespec timeout = {(time_t)(remaining / 1000000000u), (long)(remaining % 1000000000u)};
+
+  // Announce the waiter before checking the lane, see wake_producer.
+  __atomic_fetch_add(&pQueue->Waiters, 1, __ATOMIC_SEQ_CST);
+  const uint32_t head = __atomic_load_n(&pLane->Head, __ATOMIC_SEQ_CST);
+  if((HSM_LOAD_ACQUIRE(&pLane->Tail) - head) > pLane->Mask)
+  {
+    // Sleeps only if the dispatcher has not advanced the head meanwhile.
+    syscall(SYS_futex, &pLane->Head, FUTEX_WAIT_PRIVATE, head, &timeout, NULL, 0);
+  }
+  __atomic_fetch_sub(&pQueue->Waiters, 1, __ATOMIC_RELAXED);
+  return true;
+}
+#endif // defined(__linux__)
+
+//! Wake a producer blocked on the lane, after the dispatcher has fetched an event from it.
+static inline void wake_producer(event_queue_t* const pQueue, event_lane_t* const pLane)
+{
+#if defined(__linux__)
+  if(pQueue->Overflow == OVERFLOW_BLOCK)
+  {
+    // Orders the release of cell with the check of waiters, see wait_for_room.
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if(__atomic_load_n(&pQueue->Waiters, __ATOMIC_RELAXED) != 0)
+    {
+      syscall(SYS_futex, &pLane->Head, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+    }
+  }
+#else
+  (void)pQueue;
+  (void)pLane;
+#endif // defined(__linux__)
+}
+
+/** \brief Make room in the full lane as per the overflow policy of queue.
+ *
+ * \return bool false if the posted event is rejected.
+ */
+static bool make_room(event_queue_t* const pQueue,
+                      event_lane_t* const pLane,
+                      uint64_t* const pDeadline)
+{
+  switch(pQueue->Overflow)
+  {
+  case OVERFLOW_DROP_OLDEST:
+    drop_event(pQueue, pLane);
+    return true;
+
+#if defined(__linux__)
+  case OVERFLOW_BLOCK:
+    return wait_for_room(pQueue, pLane, pDeadline);
+#endif // defined(__linux__)
+
+  default:
+    (void)pDeadline;
+    return false;
+  }
+}
+
+/** \brief Attach an event queue to the state machine.
+ *  Call it before posting any event to state machine.
+ *
+ * \param pState_Machine state_machine_t* const   pointer to state machine
+ * \param pQueue event_queue_t* const             event queue
+ * \param pBuffer queued_event_t* const           cells of queue, size * HSM_QUEUE_LANES
+ * \param size uint32_t                           number of cells in each lane, must be power of 2.
+ * \return bool false if size is not power of 2.
+ *
+ */
+bool init_event_queue(state_machine_t* const pState_Machine,
+                      event_queue_t* const pQueue,
+                      queued_event_t* const pBuffer,
+                      uint32_t size)
+{
+  if((size < 2) || ((size & (size - 1)) != 0))
+  {
+    return false;
+  }
+
+  for(uint32_t lane = 0; lane < HSM_QUEUE_LANES; lane++)
+  {
+    pQueue->Lane[lane].Buffer = &pBuffer[lane * size];
+    pQueue->Lane[lane].Mask = size - 1;
+    pQueue->Lane[lane].Tail = 0;
+    pQueue->Lane[lane].Head = 0;
+    for(uint32_t index = 0; index < size; index++)
+    {
+      pQueue->Lane[lane].Buffer[index].Sequence = index;
+    }
+  }
+
+#if HSM_QUEUE_LANES > 1
+  pQueue->Nonempty = 0;
+  for(uint32_t event = 0; event < MAX_RULE_EVENTS; event++)
+  {
+    pQueue->Lane_Of[event] = HSM_QUEUE_LANES - 1;
+  }
+#endif // HSM_QUEUE_LANES > 1
+  pQueue->Payload = 0;
+  pQueue->Queued = 0;
+  pQueue->Drop_Duplicate = 0;
+  pQueue->Keep_Latest = 0;
+  pQueue->Merged = 0;
+  pQueue->Overflow = OVERFLOW_REJECT;
+  pQueue->Timeout = 0;
+  pQueue->Waiters = 0;
+  pQueue->High_Threshold = 0;
+  pQueue->Low_Threshold = 0;
+  pQueue->Backpressure = 0;
+  pQueue->Backpressure_Handler = NULL;
+  pQueue->High_Water = 0;
+  pQueue->Overflows = 0;
+  pQueue->Dropped = 0;
+  pState_Machine->Queue = pQueue;
+  return true;
+}
+
+#if HSM_QUEUE_LANES > 1
+/** \brief Set the priority lane of an event. Call it before posting any event.
+ *  By default, events are posted in the lowest priority lane.
+ *
+ * \param pQueue event_queue_t* const   event queue
+ * \param event uint32_t                event, must be below MAX_RULE_EVENTS
+ * \param lane uint32_t                 lane, 0 is the highest priority.
+ * \return bool false if event or lane is out of range.
+ *
+ */
+bool set_event_lane(event_queue_t* const pQueue, uint32_t event, uint32_t lane)
+{
+  if((event == 0) || (event >= MAX_RULE_EVENTS) || (lane >= HSM_QUEUE_LANES))
+  {
+    return false;
+  }
+  pQueue->Lane_Of[event] = (uint8_t)lane;
+  return true;
+}
+#endif // HSM_QUEUE_LANES > 1
+
+/** \brief Post the event in its lane and mark the lane as non empty.
+ *  If lane is full, the overflow policy of queue is applied. Event posted from
+ *  interrupt is always rejected on overflow, as it can't wait for other threads.
+ *  coalesced is the bit of coalesced event to mark in Queued, 0 for other events.
+ *
+ * \return bool false if the event is rejected.
+ */
+static bool queue_event(event_queue_t* const pQueue,
+                        uint32_t event,
+                        uint32_t payload,
+                        event_token_t* const pToken,
+                        uint32_t coalesced,
+                        bool fromIsr)
+{
+#if HSM_QUEUE_LANES > 1
+  const uint32_t lane = (event < MAX_RULE_EVENTS) ? pQueue->Lane_Of[event] : (HSM_QUEUE_LANES - 1);
+#else
+  const uint32_t lane = 0;
+#endif // HSM_QUEUE_LANES > 1
+  event_lane_t* const pLane = &pQueue->Lane[lane];
+
+  if(!enqueue_event(pLane, event, payload, pToken, &pQueue->Queued, coalesced))
+  {
+    uint64_t deadline = 0;
+    HSM_FETCH_ADD(&pQueue->Overflows, 1);
+    if(fromIsr)
+    {
+      return false;
+    }
+    do
+    {
+      if(!make_room(pQueue, pLane, &deadline))
+      {
+        return false;
+      }
+    }while(!enqueue_event(pLane, event, payload, pToken, &pQueue->Queued, coalesced));
+  }
+
+#if HSM_QUEUE_LANES > 1
+  // Lane is marked after the event is published, see fetch_event. It must be a read-modify-write
+  // even if the lane is already marked, to order it with the unmarking by dispatcher.
+  fetch_or(&pQueue->Nonempty, (uint32_t)1 << lane);
+#endif // HSM_QUEUE_LANES > 1
+  update_depth(pQueue, fromIsr);
+  return true;
+}
+
+/** \brief Set the behavior of queue when a lane is full. Call it before posting any event.
+ *  By default, the posted event is rejected.
+ *
+ * \param pQueue event_queue_t* const   event queue
+ * \param policy overflow_policy_t      overflow policy
+ * \param timeout uint32_t              maximum time in milliseconds to block the producer, for OVERFLOW_BLOCK.
+ * \return bool false if policy is not supported on this target.
+ *
+ */
+bool set_overflow_policy(event_queue_t* const pQueue, overflow_policy_t policy, uint32_t timeout)
+{
+#if !defined(__linux__)
+  if(policy == OVERFLOW_BLOCK)
+  {
+    return false;
+  }
+#endif // !defined(__linux__)
+
+  pQueue->Overflow = policy;
+  pQueue->Timeout = timeout;
+  return true;
+}
+
+/** \brief Set the thresholds of backpressure. The backpressure is asserted when the number
+ *  of queued events reaches the high threshold and released when it drops to the low threshold.
+ *  Call it before posting any event.
+ *
+ * \param pQueue event_queue_t* const              event queue
+ * \param high uint32_t                            high threshold, 0 disables the backpressure.
+ * \param low uint32_t                             low threshold, must be below high threshold.
+ * \param handler backpressure_handler_t           called on each change of backpressure. It can be NULL.
+ *                                                 It is called from producer or dispatcher thread.
+ * \return bool false if thresholds are invalid.
+ *
+ */
+bool set_backpressure(event_queue_t* const pQueue,
+                      uint32_t high,
+                      uint32_t low,
+                      backpressure_handler_t handler)
+{
+  if((high != 0) && (low >= high))
+  {
+    return false;
+  }
+
+  pQueue->High_Threshold = high;
+  pQueue->Low_Threshold = low;
+  pQueue->Backpressure_Handler = handler;
+  return true;
+}
+
+/** \brief Set the coalescing rule of an event. Call it before posting any event.
+ *
+ * \param pQueue event_queue_t* const   event queue
+ * \param event uint32_t                event, must be below MAX_RULE_EVENTS
+ * \param rule coalesce_rule_t          coalescing rule
+ * \return bool false if event can't be coalesced.
+ *
+ */
+bool set_coalescing(event_queue_t* const pQueue, uint32_t event, coalesce_rule_t rule)
+{
+  if((event == 0) || (event >= MAX_RULE_EVENTS))
+  {
+    return false;
+  }
+
+  const uint32_t bit = (uint32_t)1 << event;
+  pQueue->Drop_Duplicate &= ~bit;
+  pQueue->Keep_Latest &= ~bit;
+  if(rule == COALESCE_DROP_DUPLICATE)
+  {
+    pQueue->Drop_Duplicate |= bit;
+  }
+  else if(rule == COALESCE_KEEP_LATEST)
+  {
+    pQueue->Keep_Latest |= bit;
+  }
+  return true;
+}
+
+/** \brief Post the event to queue, merging the coalesced event with the queued one.
+ *
+ * \return bool false if the event is rejected.
+ */
+static bool post_to_queue(event_queue_t* const pQueue,
+                          uint32_t event,
+                          uint32_t payload,
+                          event_token_t* const pToken,
+                          bool fromIsr)
+{
+  if((event < MAX_RULE_EVENTS) && (pToken == NULL))
+  {
+    const uint32_t bit = (uint32_t)1 << event;
+    if(((pQueue->Drop_Duplicate | pQueue->Keep_Latest) & bit) != 0)
+    {
+      if((pQueue->Keep_Latest & bit) != 0)
+      {
+        // Store the payload before marking the event as queued, so that dispatcher
+        // reads the latest payload when it fetches the event.
+        HSM_STORE_RELEASE(&pQueue->Latest[event], payload);
+      }
+
+      // Event is marked only when it is sure to be delivered, see enqueue_event. Hence a post
+      // merged with it can't be lost, even if the first post is rejected by the overflow policy.
+      // The check must be a read-modify-write, to order the payload stored above with the
+      // unmarking by dispatcher.
+      uint32_t queued = HSM_LOAD_ACQUIRE(&pQueue->Queued);
+      while(((queued & bit) != 0) && !HSM_COMPARE_EXCHANGE(&pQueue->Queued, &queued, queued));
+      if((queued & bit) != 0)
+      {
+        HSM_FETCH_ADD(&pQueue->Merged, 1);
+        return true;
+      }
+
+      // Concurrent first posts may queue the event more than once.
+      return queue_event(pQueue, event, payload, NULL, bit, fromIsr);
+    }
+  }
+
+  return queue_event(pQueue, event, payload, pToken, 0, fromIsr);
+}
+
+/** \brief Post an event with payload to the state machine having event queue.
+ *  Coalesced event is merged if the same event is already in the queue.
+ *  Event posted with completion token is always queued.
+ *  It is safe to call from multiple threads.
+ *
+ * \param pState_Machine state_machine_t* const   pointer to state machine
+ * \param event uint32_t                          event to post, must not be 0
+ * \param payload uint32_t                        payload of event, see get_event_payload
+ * \param pToken event_token_t* const             completion token, see post_event
+ * \return bool false if lane is full and the event is rejected by overflow policy, or event is out of range.
+ *
+ */
+bool post_event_payload(state_machine_t* const pState_Machine,
+                        uint32_t event,
+                        uint32_t payload,
+                        event_token_t* const pToken)
+{
+  if(!is_event_in_range(event))
+  {
+    return false;
+  }
+
+  const bool posted = post_to_queue(pState_Machine->Queue, event, payload, pToken, false);
+#if HSM_EVENT_RECORDER
+  if(posted)
+  {
+    record_post(pState_Machine, event);
+  }
+#endif // HSM_EVENT_RECORDER
+  return posted;
+}
+
+/** \brief Fetch the next event from the queue of state machine. Called by the dispatcher
+ *  when state machine has no pending event.
+ *
+ * \param pState_Machine state_machine_t* const   pointer to state machine having event queue
+ * \return bool false if queue is empty.
+ *
+ */
+bool fetch_event(state_machine_t* const pState_Machine)
+{
+  event_queue_t* const pQueue = pState_Machine->Queue;
+  queued_event_t cell;
+
+  uint32_t lane = 0;
+
+#if HSM_QUEUE_LANES > 1
+  bool fetched = false;
+  uint32_t nonempty = HSM_LOAD_ACQUIRE(&pQueue->Nonempty);
+
+  // Fetch from the highest priority non empty lane.
+  while((nonempty != 0) && !fetched)
+  {
+    lane = first_lane(nonempty);
+    const uint32_t bit = (uint32_t)1 << lane;
+    fetched = dequeue_event(&pQueue->Lane[lane], &cell);
+    if(!fetched)
+    {
+      // Lane is empty, unmark it. A producer marks the lane after publishing the event,
+      // hence check the lane again for an event posted before the lane is unmarked.
+      clear_bits(&pQueue->Nonempty, bit);
+      fetched = dequeue_event(&pQueue->Lane[lane], &cell);
+      if(fetched)
+      {
+        fetch_or(&pQueue->Nonempty, bit);
+      }
+      nonempty &= ~bit;
+    }
+  }
+
+  if(!fetched)
+  {
+    return false;
+  }
+#else
+  if(!dequeue_event(&pQueue->Lane[lane], &cell))
+  {
+    return false;
+  }
+#endif // HSM_QUEUE_LANES > 1
+
+  wake_producer(pQueue, &pQueue->Lane[lane]);
+  release_backpressure(pQueue);
+
+  const uint32_t event = cell.Event;
+  uint32_t payload = cell.Payload;
+#if HSM_EVENT_COMPLETION
+  pState_Machine->Token = cell.Token;
+#endif // HSM_EVENT_COMPLETION
+
+  if(event < MAX_RULE_EVENTS)
+  {
+    const uint32_t bit = (uint32_t)1 << event;
+    if(((pQueue->Drop_Duplicate | pQueue->Keep_Latest) & bit) != 0)
+    {
+      // Event posted after this point is queued again.
+      clear_bits(&pQueue->Queued, bit);
+      if((pQueue->Keep_Latest & bit) != 0)
+      {
+        payload = HSM_LOAD_ACQUIRE(&pQueue->Latest[event]);
+      }
+    }
+  }
+
+  pQueue->Payload = payload;
+  pState_Machine->Event = event;
+  return true;
+}
+#endif // HSM_EVENT_QUEUE
+
+/** \brief Post an event to the state machine.
+ *  If state machine has event queue, the event is queued. Otherwise the event is posted only
+ *  if the state machine has no pending event.
+ *  It is safe to call from multiple threads, but not concurrently with direct write of Event.
+ *  The accepted event is recorded if a recorder is attached to the state machine, see attach_recorder.
+ *
+ * \param pState_Machine state_machine_t* const   pointer to state machine
+ * \param event uint32_t                          event to post, must not be 0
+ * \param pToken event_token_t* const             completion token, NULL if not required.
+ *                                                It must stay valid until it is resolved.
+ *                                                Must be NULL if HSM_EVENT_COMPLETION is disabled.
+ * \return bool false if state machine has already a pending event, queue is full or event is out of range,
+ *              see is_event_in_range.
+ *
+ */
+bool post_event(state_machine_t* const pState_Machine,
+                uint32_t event,
+                event_token_t* const pToken)
+{
+  if(!is_event_in_range(event))
+  {
+    return false;
+  }
+
+#if HSM_EVENT_QUEUE
+  if(pState_Machine->Queue != NULL)
+  {
+    return post_event_payload(pState_Machine, event, 0, pToken);
+  }
+#endif // HSM_EVENT_QUEUE
+
+#if HSM_EVENT_COMPLETION
+  event_token_t* pExpected = NULL;
+  event_token_t* const pClaim = (pToken != NULL) ? pToken : &Anonymous_Token;
+
+  // Token slot is released by dispatcher only after the pending event is cleared.
+  // Hence the producer that claims the slot owns the Event as well.
+  if(!HSM_COMPARE_EXCHANGE(&pState_Machine->Token, &pExpected, pClaim))
+  {
+    return false;
+  }
+
+  // Reset the token after the claim, a rejected post doesn't modify it. Dispatcher
+  // reads it only after the event is published.
+  if(pToken != NULL)
+  {
+    pToken->Status = TOKEN_PENDING;
+  }
+
+  HSM_STORE_RELEASE(&pState_Machine->Event, event);
+#else
+  (void)pToken;
+#if HSM_COMPACT_STATE
+  uint16_t expected = 0;
+#else
+  uint32_t expected = 0;
+#endif // HSM_COMPACT_STATE
+  if(!HSM_COMPARE_EXCHANGE(&pState_Machine->Event, &expected, event))
+  {
+    return false;
+  }
+#endif // HSM_EVENT_COMPLETION
+
+#if HSM_EVENT_RECORDER
+  record_post(pState_Machine, event);
+#endif // HSM_EVENT_RECORDER
+  return true;
+}
+
+/** \brief Post an event to the state machine from interrupt service routine or signal handler.
+ *  It is async-signal-safe: it uses only lock-free atomic operations on the state machine and
+ *  its queue, no lock, no allocation and no system call. It never waits for other threads,
+ *  hence the event is rejected if the lane is full, irrespective of the overflow policy.
+ *  The backpressure is not evaluated and its handler is not called.
+ *  The clock of recorder attached to the state machine must be async-signal-safe.
+ *  Wake the dispatcher after it returns true, e.g. using runtime_post_from_signal on Linux.
+ *
+ * \param pState_Machine state_machine_t* const   pointer to state machine
+ * \param event uint32_t                          event to post, must not be 0
+ * \param payload uint32_t                        payload of event, ignored if state machine has no event queue.
+ * \return bool false if state machine has already a pending event, queue is full or event is out of range.
+ *
+ */
+bool post_event_from_isr(state_machine_t* const pState_Machine,
+                         uint32_t event,
+                         uint32_t payload)
+{
+  if(!is_event_in_range(event))
+  {
+    return false;
+  }
+
+#if HSM_EVENT_QUEUE
+  if(pState_Machine->Queue != NULL)
+  {
+    const bool posted = post_to_queue(pState_Machine->Queue, event, payload, NULL, true);
+#if HSM_EVENT_RECORDER
+    if(posted)
+    {
+      record_post(pState_Machine, event);
+    }
+#endif // HSM_EVENT_RECORDER
+    return posted;
+  }
+#endif // HSM_EVENT_QUEUE
+
+  (void)payload;
+  return post_event(pState_Machine, event, NULL);
+}
+
+#if HSM_EVENT_COMPLETION
+/** \brief Block the calling thread until the posted event is processed.
+ *  On Linux the thread sleeps on futex, on other targets it polls the token and calls
+ *  HSM_WAIT_YIELD between the polls. It yields on other POSIX targets, otherwise it busy polls.
+ *
+ * \param pToken event_token_t* const   completion token passed to post_event
+ * \return state_machine_result_t       result of run to completion step of the event
+ *
+ */
+state_machine_result_t wait_event(event_token_t* const pToken)
+{
+#if defined(__GNUC__)
+  uint32_t status = TOKEN_PENDING;
+  // Announce the waiter, so that dispatcher calls the futex wake only if required.
+  __atomic_compare_exchange_n(&pToken->Status, &status, TOKEN_WAITING, false,
+                              __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE);
+#endif
+
+  while(HSM_LOAD_ACQUIRE(&pToken->Status) != TOKEN_COMPLETED)
+  {
+#if defined(__linux__)
+    syscall(SYS_futex, &pToken->Status, FUTEX_WAIT_PRIVATE, TOKEN_WAITING, NULL, NULL, 0);
+#else
+    HSM_WAIT_YIELD();
+#endif
+  }
+  return pToken->Result;
+}
+
+/** \brief Resolve the token with the result of run to completion step.
+ *  It is called by the dispatcher. Producer may release the token as soon as it is resolved.
+ *
+ * \param pToken event_token_t* const     completion token
+ * \param result state_machine_result_t   result of run to completion step
+ *
+ */
+void resolve_event_token(event_token_t* const pToken, state_machine_result_t result)
+{
+  if(pToken == &Anonymous_Token)
+  {
+    return;
+  }
+
+  pToken->Result = result;
+#if defined(__GNUC__)
+  if(__atomic_exchange_n(&pToken->Status, TOKEN_COMPLETED, __ATOMIC_RELEASE) == TOKEN_WAITING)
+  {
+#if defined(__linux__)
+    syscall(SYS_futex, &pToken->Status, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+#endif
+  }
+#else
+  pToken->Status = TOKEN_COMPLETED;
+#endif
+}
+
+#endif // HSM_EVENT_COMPLETION
@@ -0,0 +1,250 @@
+/**
+ * \file
+ * \brief Posting events to state machines from other threads.
+ *
+ *  post_event stores the event in the state machine if it has no pending event.
+ *  If HSM_EVENT_COMPLETION is enabled, it optionally attaches a completion token.
+ *  The dispatcher resolves the token with the result of the run to completion step. The producer can wait on the token without spinning.
+
+ * \author  Nandkishor Biradar
+ * \date    19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+#ifndef HSM_POST_H
+#define HSM_POST_H
+
+/*
+ *  --------------------- DEFINITION ---------------------
+ */
+
+#if HSM_EVENT_QUEUE
+//! Events below this value can have coalescing rule and priority lane.
+#define MAX_RULE_EVENTS      32
+#endif // HSM_EVENT_QUEUE
+
+/*
+ *  --------------------- ENUMERATION ---------------------
+ */
+
+#if HSM_EVENT_QUEUE
+//! Coalescing rule of event
+typedef enum
+{
+  COALESCE_NONE,            //!< Each posted event is queued.
+  COALESCE_DROP_DUPLICATE,  //!< Event is dropped if it is already in the queue.
+  COALESCE_KEEP_LATEST,     //!< Event is merged with the queued event, dispatcher gets the latest payload.
+}coalesce_rule_t;
+
+//! Behavior of event queue when the lane of posted event is full
+typedef enum
+{
+  OVERFLOW_REJECT,          //!< Posted event is rejected.
+  OVERFLOW_DROP_OLDEST,     //!< Oldest event of the lane is dropped to make room for the posted event.
+  OVERFLOW_BLOCK,           //!< Producer is blocked until room is available or timeout expires. Linux only.
+}overflow_policy_t;
+#endif // HSM_EVENT_QUEUE
+
+/*
+ *  --------------------- STRUCTURE ---------------------
+ */
+
+#if HSM_EVENT_COMPLETION
+//! Completion token of posted event. It is owned by the producer, typically on its stack.
+struct event_token
+{
+  uint32_t Status;                //!< 0: pending, 1: completed, 2: pending and producer is waiting.
+  state_machine_result_t Result;  //!< Result of run to completion step of the posted event.
+};
+#endif // HSM_EVENT_COMPLETION
+
+#if HSM_EVENT_QUEUE
+//! Called when the backpressure of event queue is asserted (true) or released (false).
+typedef void (*backpressure_handler_t)(event_queue_t* const pQueue, bool asserted);
+
+//! Cell of event queue
+typedef struct
+{
+  uint32_t Sequence;          //!< Sequence number to synchronize producers and dispatcher
+  uint32_t Event;             //!< Posted event
+  uint32_t Payload;           //!< Payload of posted event
+#if HSM_EVENT_COMPLETION
+  event_token_t* Token;       //!< Completion token of posted event
+#endif // HSM_EVENT_COMPLETION
+}queued_event_t;
+
+//! Bounded multi producer FIFO of events. Producers remove events only to drop the oldest one.
+typedef struct
+{
+  queued_event_t* Buffer;     //!< User provided cells. Number of cells must be power of 2.
+  uint32_t Mask;              //!< Number of cells - 1
+  uint32_t Tail;              //!< Position of next post, shared by producers
+  uint32_t Head;              //!< Position of next fetch
+}event_lane_t;
+
+//! Event queue of state machine
+struct event_queue
+{
+  event_lane_t Lane[HSM_QUEUE_LANES]; //!< Priority lanes. Lane 0 has the highest priority.
+#if HSM_QUEUE_LANES > 1
+  uint32_t Nonempty;          //!< Bitmask of lanes that may have an event
+  uint8_t Lane_Of[MAX_RULE_EVENTS];   //!< Lane of events. Other events use the lowest priority lane.
+#endif // HSM_QUEUE_LANES > 1
+  uint32_t Payload;           //!< Payload of the event under dispatch
+  uint32_t Queued;            //!< Bitmask of coalesced events present in the queue
+  uint32_t Drop_Duplicate;    //!< Bitmask of events with COALESCE_DROP_DUPLICATE rule
+  uint32_t Keep_Latest;       //!< Bitmask of events with COALESCE_KEEP_LATEST rule
+  uint32_t Merged;            //!< Number of posted events merged with queued events
+  uint32_t Latest[MAX_RULE_EVENTS];  //!< Latest payload of events with COALESCE_KEEP_LATEST rule
+  overflow_policy_t Overflow; //!< Behavior when the lane of posted event is full
+  uint32_t Timeout;           //!< Maximum time in milliseconds to block the producer with OVERFLOW_BLOCK
+  uint32_t Waiters;           //!< Number of producers blocked on full lane
+  uint32_t High_Threshold;    //!< Queue depth to assert the backpressure, 0: disabled
+  uint32_t Low_Threshold;     //!< Queue depth to release the backpressure
+  uint32_t Backpressure;      //!< 1 if backpressure is asserted
+  backpressure_handler_t Backpressure_Handler;  //!< Called on change of backpressure, can be NULL
+  uint32_t High_Water;        //!< Maximum number of events present in the queue
+  uint32_t Overflows;         //!< Number of posts that found the lane full
+  uint32_t Dropped;           //!< Number of events dropped by OVERFLOW_DROP_OLDEST
+};
+#endif // HSM_EVENT_QUEUE
+
+/*
+ *  --------------------- EXPORTED FUNCTION ---------------------
+ */
+
+#ifdef __cplusplus
+extern "C"  {
+#endif // __cplusplus
+
+extern bool post_event(state_machine_t* const pState_Machine,
+                       uint32_t event,
+                       event_token_t* const pToken);
+
+extern bool post_event_from_isr(state_machine_t* const pState_Machine,
+                                uint32_t event,
+                                uint32_t payload);
+
+#if HSM_EVENT_QUEUE
+extern bool init_event_queue(state_machine_t* const pState_Machine,
+                             event_queue_t* const pQueue,
+                             queued_event_t* const pBuffer,
+                             uint32_t size);
+
+extern bool set_coalescing(event_queue_t* const pQueue, uint32_t event, coalesce_rule_t rule);
+
+extern bool set_overflow_policy(event_queue_t* const pQueue, overflow_policy_t policy, uint32_t timeout);
+
+extern bool set_backpressure(event_queue_t* const pQueue,
+                             uint32_t high,
+                             uint32_t low,
+                             backpressure_handler_t handler);
+
+#if HSM_QUEUE_LANES > 1
+extern bool set_event_lane(event_queue_t* const pQueue, uint32_t event, uint32_t lane);
+#endif // HSM_QUEUE_LANES > 1
+
+extern bool post_event_payload(state_machine_t* const pState_Machine,
+                               uint32_t event,
+                               uint32_t payload,
+                               event_token_t* const pToken);
+
+extern bool fetch_event(state_machine_t* const pState_Machine);
+#endif // HSM_EVENT_QUEUE
+
+#if HSM_EVENT_COMPLETION
+//! Token attached to events posted without completion token.
+extern event_token_t Anonymous_Token;
+
+//! On targets other than Linux, wait_event polls the token and calls HSM_WAIT_YIELD() between the polls.
+//! It yields on other POSIX targets and busy polls on the rest. Define HSM_WAIT_YIELD to yield
+//! or sleep on such targets, e.g. taskYIELD() on FreeRTOS, otherwise the waiting thread keeps the CPU busy.
+extern state_machine_result_t wait_event(event_token_t* const pToken);
+
+extern void resolve_event_token(event_token_t* const pToken, state_machine_result_t result);
+#endif // HSM_EVENT_COMPLETION
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+/*
+ *  --------------------- Inline functions ---------------------
+ */
+
+#if HSM_EVENT_COMPLETION
+/** \brief Check if the posted event is processed, without blocking.
+ *
+ * \param pToken const event_token_t* const  completion token
+ * \return bool true if the run to completion step of event is completed.
+ *
+ */
+static inline bool is_event_completed(const event_token_t* const pToken)
+{
+  return HSM_LOAD_ACQUIRE(&pToken->Status) == 1;
+}
+#endif // HSM_EVENT_COMPLETION
+
+#if HSM_EVENT_QUEUE
+/** \brief Get the payload of the event under dispatch. Call it from the state handler.
+ *
+ * \param pState_Machine const state_machine_t* const   pointer to state machine with event queue
+ * \return uint32_t payload
+ *
+ */
+static inline uint32_t get_event_payload(const state_machine_t* const pState_Machine)
+{
+  return pState_Machine->Queue->Payload;
+}
+
+/** \brief Get the number of posted events merged with the queued events.
+ *
+ * \param pQueue const event_queue_t* const   event queue
+ * \return uint32_t number of merged events
+ *
+ */
+static inline uint32_t get_merged_events(const event_queue_t* const pQueue)
+{
+  return HSM_LOAD_ACQUIRE(&pQueue->Merged);
+}
+
+/** \brief Check if the event queue is under backpressure. It is cheap enough to poll before each post.
+ *
+ * \param pQueue const event_queue_t* const   event queue
+ * \return bool true if backpressure is asserted.
+ *
+ */
+static inline bool is_backpressured(const event_queue_t* const pQueue)
+{
+  return HSM_LOAD_ACQUIRE(&pQueue->Backpressure) != 0;
+}
+
+/** \brief Get the maximum number of events present in the queue since it is initialized.
+ *
+ * \param pQueue const event_queue_t* const   event queue
+ * \return uint32_t high water mark
+ *
+ */
+static inline uint32_t get_high_water_mark(const event_queue_t* const pQueue)
+{
+  return HSM_LOAD_ACQUIRE(&pQueue->High_Water);
+}
+
+/** \brief Get the number of events dropped by OVERFLOW_DROP_OLDEST policy.
+ *
+ * \param pQueue const event_queue_t* const   event queue
+ * \return uint32_t number of dropped events
+ *
+ */
+static inline uint32_t get_dropped_events(const event_queue_t* const pQueue)
+{
+  return HSM_LOAD_ACQUIRE(&pQueue->Dropped);
+}
+#endif // HSM_EVENT_QUEUE
+
+#endif // HSM_POST_H
@@ -0,0 +1,322 @@
+/**
+ * \file
+ * \brief Record and replay of events posted to state machines.
+
+ * \author  Nandkishor Biradar
+ * \date    19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+/*
+ *  --------------------- INCLUDE FILES ---------------------
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE       // clock_nanosleep in strict ISO C mode
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#if defined(__linux__)
+#include <errno.h>
+#include <time.h>
+#endif // __linux__
+
+#include "hsm.h"
+#include "hsm_post.h"
+#include "hsm_record.h"
+
+/*
+ *  --------------------- DEFINITION ---------------------
+ */
+
+//! Index of state that is not present in the state table.
+#define UNKNOWN_STATE   0xFFFFFFFFu
+
+/*
+ *  --------------------- FUNCTION BODY ---------------------
+ */
+
+/** \brief Reserves a record in the log. It is safe to call from multiple threads.
+ *
+ * \return event_record_t* reserved record or NULL if log is full.
+ */
+static event_record_t* reserve_record(event_recorder_t* const pRecorder)
+{
+#if defined(__GNUC__)
+  uint32_t index = __atomic_load_n(&pRecorder->Count, __ATOMIC_RELAXED);
+  do
+  {
+    if(index >= pRecorder->Size)
+    {
+      return NULL;
+    }
+  }while(!__atomic_compare_exchange_n(&pRecorder->Count, &index, index + 1, true,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+#else
+  if(pRecorder->Count >= pRecorder->Size)
+  {
+    return NULL;
+  }
+  uint32_t index = pRecorder->Count++;
+#endif
+  return &pRecorder->Log[index];
+}
+
+/** \brief Converts the current state of state machine to its index in the state table.
+ */
+static uint32_t state_index(const event_recorder_t* const pRecorder,
+                            const state_machine_t* const pState_Machine)
+{
+#if HSM_COMPACT_STATE
+  (void)(pRecorder);
+  return pState_Machine->State;
+#else
+  const state_t* const pState = get_state(pState_Machine);
+  for(uint32_t index = 0; index < pRecorder->Total_States; index++)
+  {
+    if(pRecorder->State_Table[index] == pState)
+    {
+      return index;
+    }
+  }
+  return UNKNOWN_STATE;
+#endif // HSM_COMPACT_STATE
+}
+
+/** \brief Initializes the event recorder.
+ *
+ * \param pRecorder event_recorder_t* const       recorder to initialize
+ * \param pLog event_record_t* const              buffer to store the records
+ * \param size uint32_t                           maximum number of records in the buffer
+ * \param clock record_clock                      timestamp source
+ * \param pState_Table[] const state_t* const     table of states used for state checkpoint.
+ *                                                Not used in compact state machine, can be NULL.
+ * \param totalStates uint32_t                    number of states in the table
+ *
+ */
+void init_recorder(event_recorder_t* const pRecorder,
+                   event_record_t* const pLog,
+                   uint32_t size,
+                   record_clock clock,
+                   const state_t* const pState_Table[],
+                   uint32_t totalStates)
+{
+  pRecorder->Log = pLog;
+  pRecorder->Size = size;
+  pRecorder->Count = 0;
+  pRecorder->Clock = clock;
+  pRecorder->State_Table = pState_Table;
+  pRecorder->Total_States = totalStates;
+}
+
+/** \brief Records the event posted to a state machine. Call it with the event
+ *  whenever an event is written to the state machine. It is safe to call from multiple threads.
+ *
+ * \param pRecorder event_recorder_t* const   event recorder
+ * \param machine uint32_t                    index of state machine in the array passed to dispatch_event
+ * \param event uint32_t                      posted event
+ * \return bool                               false if log is full
+ *
+ */
+bool record_event(event_recorder_t* const pRecorder, uint32_t machine, uint32_t event)
+{
+  event_record_t* const pRecord = reserve_record(pRecorder);
+  if(pRecord == NULL)
+  {
+    return false;
+  }
+
+  pRecord->Time = pRecorder->Clock();
+  pRecord->Machine = machine;
+  pRecord->Value = event;
+  return true;
+}
+
+#if HSM_EVENT_RECORDER
+/** \brief Attaches the recorder to state machine. post_event records the events posted
+ *  to the state machine, once they are accepted. Call it before posting events to the state machine.
+ *
+ * \param pState_Machine state_machine_t* const   state machine
+ * \param pRecorder event_recorder_t* const       event recorder, NULL to stop recording.
+ * \param machine uint32_t                        index of state machine in the array passed to dispatch_event
+ *
+ */
+void attach_recorder(state_machine_t* const pState_Machine,
+                     event_recorder_t* const pRecorder,
+                     uint32_t machine)
+{
+  pState_Machine->Record_Index = machine;
+  pState_Machine->Recorder = pRecorder;
+}
+#endif // HSM_EVENT_RECORDER
+
+/** \brief Records the current states of all the state machines as checkpoint.
+ *  The replay compares the replayed states against the checkpoint.
+ *  Call it from the dispatcher thread, when no event is being dispatched.
+ *
+ * \param pRecorder event_recorder_t* const         event recorder
+ * \param pState_Machine[] state_machine_t* const   array of state machines
+ * \param quantity uint32_t                         number of state machines
+ * \return bool                                     false if log is full
+ *
+ */
+bool record_states(event_recorder_t* const pRecorder,
+                   state_machine_t* const pState_Machine[],
+                   uint32_t quantity)
+{
+  for(uint32_t index = 0; index < quantity; index++)
+  {
+    event_record_t* const pRecord = reserve_record(pRecorder);
+    if(pRecord == NULL)
+    {
+      return false;
+    }
+
+    pRecord->Time = pRecorder->Clock();
+    pRecord->Machine = index | RECORD_STATE_CHECKPOINT;
+    pRecord->Value = state_index(pRecorder, pState_Machine[index]);
+  }
+  return true;
+}
+
+/** \brief Replays the recorded events through dispatch_event.
+ *  Each event is posted to its state machine using post_event and dispatched to completion before the next record.
+ *  Events rejected by post_event, e.g. out of range of the state machine, are counted in the report.
+ *  Only the records present at the start of replay are replayed. State machines attached to a recorder
+ *  record the replayed events, detach them using attach_recorder to keep the recording unchanged.
+ *
+ * \param pRecording const event_recorder_t* const  recording to replay
+ * \param pState_Machine[] state_machine_t* const   array of state machines in the recorded initial states
+ * \param quantity uint32_t                         number of state machines
+ * \param wait replay_wait                          NULL: replay as fast as possible.
+ *                                                  Otherwise, it is called to wait until the recorded time of each event,
+ *                                                  relative to the start of replay. Time taken by dispatch doesn't add up.
+ * \param pReport replay_report_t* const            result of replay
+ * \return state_machine_result_t                   EVENT_HANDLED or error returned by dispatch_event
+ *
+ */
+state_machine_result_t replay_events(const event_recorder_t* const pRecording,
+                                     state_machine_t* const pState_Machine[],
+                                     uint32_t quantity,
+                                     replay_wait wait,
+                                     replay_report_t* const pReport
+#if STATE_MACHINE_LOGGER
+                                     ,state_machine_event_logger event_logger
+                                     ,state_machine_result_logger result_logger
+#endif // STATE_MACHINE_LOGGER
+                                     )
+{
+  state_machine_result_t result = EVENT_HANDLED;
+
+  pReport->Events = 0;
+  pReport->Rejected = 0;
+  pReport->Checkpoints = 0;
+  pReport->Divergences = 0;
+
+  // Records appended during the replay, e.g. by state machines attached to the same recorder, are not replayed.
+  const uint32_t count = pRecording->Count;
+  const uint32_t start = pRecording->Clock();
+  const uint32_t origin = (count != 0) ? pRecording->Log[0].Time : 0;
+  for(uint32_t index = 0; index < count; index++)
+  {
+    const event_record_t* const pRecord = &pRecording->Log[index];
+    const uint32_t machine = pRecord->Machine & ~RECORD_STATE_CHECKPOINT;
+    if(machine >= quantity)
+    {
+      continue;
+    }
+
+    if(wait != NULL)
+    {
+      // Wait until the absolute deadline, hence the time taken by dispatch doesn't accumulate.
+      // Timestamps of events posted from different threads may not be in order, the deadline
+      // of such event has already passed.
+      wait(start + (pRecord->Time - origin));
+    }
+
+    if(pRecord->Machine & RECORD_STATE_CHECKPOINT)
+    {
+      pReport->Checkpoints++;
+      if(state_index(pRecording, pState_Machine[machine]) != pRecord->Value)
+      {
+        pReport->Divergences++;
+      }
+      continue;
+    }
+
+    // Post it as in the live run, so that queue, coalescing rules and recorder apply the same way.
+    if(!post_event(pState_Machine[machine], pRecord->Value, NULL))
+    {
+      pReport->Rejected++;
+      continue;
+    }
+    pReport->Events++;
+    do
+    {
+      result = dispatch_event(pState_Machine, quantity
+#if STATE_MACHINE_LOGGER
+                              ,event_logger, result_logger
+#endif // STATE_MACHINE_LOGGER
+                              );
+    }while(result == BUDGET_EXHAUSTED);
+    if(result != EVENT_HANDLED)
+    {
+      break;
+    }
+  }
+  pReport->Elapsed = pRecording->Clock() - start;
+  return result;
+}
+
+#if defined(__linux__)
+/** \brief Returns the time of monotonic clock in microseconds. It can be used as record_clock.
+ *  It wraps around after about 71 minutes.
+ *
+ * \return uint32_t current time in microseconds
+ *
+ */
+uint32_t record_clock_monotonic(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t)((uint64_t)now.tv_sec * 1000000u + (uint64_t)now.tv_nsec / 1000u);
+}
+
+/** \brief Sleeps until the monotonic clock reaches the deadline. It is replay_wait
+ *  for the recordings of record_clock_monotonic.
+ *
+ * \param deadline uint32_t   absolute time in microseconds of record_clock_monotonic
+ *
+ */
+void replay_wait_monotonic(uint32_t deadline)
+{
+  struct timespec until;
+  clock_gettime(CLOCK_MONOTONIC, &until);
+
+  const uint32_t now = (uint32_t)((uint64_t)until.tv_sec * 1000000u + (uint64_t)until.tv_nsec / 1000u);
+  const int32_t remaining = (int32_t)(deadline - now);
+  if(remaining <= 0)
+  {
+    return;
+  }
+
+  // Convert the deadline to absolute time of the same clock reading.
+  const uint64_t target = (uint64_t)until.tv_nsec - ((uint64_t)until.tv_nsec % 1000u)
+                        + ((uint64_t)remaining * 1000u);
+  until.tv_sec += (time_t)(target / 1000000000u);
+  until.tv_nsec = (long)(target % 1000000000u);
+
+  while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL) == EINTR)
+  {
+    // Interrupted by signal, sleep again until the same deadline.
+  }
+}
+#endif // __linux__
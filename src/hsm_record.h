@@ -0,0 +1,118 @@
+/**
+ * \file
+ * \brief Record and replay of events posted to state machines.
+ *
+ *  The recorder captures every posted event with timestamp and index of target
+ *  state machine into a binary log. With HSM_EVENT_RECORDER enabled, post_event records
+ *  the events of state machines attached to a recorder. Checkpoints of the states of state machines
+ *  can be stored in the same log. The replay feeds the log through dispatch_event
+ *  and reports the throughput and divergence from the recorded states.
+
+ * \author  Nandkishor Biradar
+ * \date    19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+#ifndef HSM_RECORD_H
+#define HSM_RECORD_H
+
+/*
+ *  --------------------- DEFINITION ---------------------
+ */
+
+//! Set in the Machine field of record to mark it as state checkpoint.
+#define RECORD_STATE_CHECKPOINT     0x80000000u
+
+/*
+ *  --------------------- STRUCTURE ---------------------
+ */
+
+//! Returns the current time in ticks. Resolution of tick is defined by user.
+typedef uint32_t (*record_clock)(void);
+//! Waits until record_clock reaches the given tick. Returns immediately if the tick has passed.
+//! Used by real-time replay.
+typedef void (*replay_wait)(uint32_t deadline);
+
+//! Single entry of binary log.
+typedef struct
+{
+  uint32_t Time;      //!< Timestamp in ticks of record_clock
+  uint32_t Machine;   //!< Index of state machine. RECORD_STATE_CHECKPOINT is set for state checkpoint.
+  uint32_t Value;     //!< Posted event or index of state in state table for checkpoint.
+}event_record_t;
+
+//! Event recorder
+struct event_recorder
+{
+  event_record_t* Log;              //!< Buffer to store the records
+  uint32_t Size;                    //!< Maximum number of records in the buffer
+  uint32_t Count;                   //!< Number of records stored in the buffer
+  record_clock Clock;               //!< Timestamp source
+  const state_t* const* State_Table; //!< Table to convert state into index for checkpoint
+  uint32_t Total_States;            //!< Number of states in the State_Table
+};
+
+//! Result of replay
+typedef struct
+{
+  uint32_t Events;        //!< Number of events dispatched
+  uint32_t Rejected;      //!< Number of events rejected by post_event, e.g. out of range of compact state machine
+  uint32_t Checkpoints;   //!< Number of states compared
+  uint32_t Divergences;   //!< Number of states that are different from recorded states
+  uint32_t Elapsed;       //!< Time taken by replay in ticks of record_clock
+}replay_report_t;
+
+/*
+ *  --------------------- EXPORTED FUNCTION ---------------------
+ */
+
+#ifdef __cplusplus
+extern "C"  {
+#endif // __cplusplus
+
+extern void init_recorder(event_recorder_t* const pRecorder,
+                          event_record_t* const pLog,
+                          uint32_t size,
+                          record_clock clock,
+                          const state_t* const pState_Table[],
+                          uint32_t totalStates);
+
+extern bool record_event(event_recorder_t* const pRecorder, uint32_t machine, uint32_t event);
+
+#if HSM_EVENT_RECORDER
+extern void attach_recorder(state_machine_t* const pState_Machine,
+                            event_recorder_t* const pRecorder,
+                            uint32_t machine);
+#endif // HSM_EVENT_RECORDER
+
+extern bool record_states(event_recorder_t* const pRecorder,
+                          state_machine_t* const pState_Machine[],
+                          uint32_t quantity);
+
+extern state_machine_result_t replay_events(const event_recorder_t* const pRecording,
+                                            state_machine_t* const pState_Machine[],
+                                            uint32_t quantity,
+                                            replay_wait wait,
+                                            replay_report_t* const pReport
+#if STATE_MACHINE_LOGGER
+                                            ,state_machine_event_logger event_logger
+                                            ,state_machine_result_logger result_logger
+#endif // STATE_MACHINE_LOGGER
+                                            );
+
+#if defined(__linux__)
+extern uint32_t record_clock_monotonic(void);
+
+extern void replay_wait_monotonic(uint32_t deadline);
+#endif // __linux__
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // HSM_RECORD_H
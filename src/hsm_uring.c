@@ -0,0 +1,290 @@
+/**
+ * \file
+ * \brief io_uring event source of state machines.
+
+ * \author  Nandkishor Biradar
+ * \date    19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+/*
+ *  --------------------- INCLUDE FILES ---------------------
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE       // syscall and MAP_POPULATE in strict ISO C mode
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "hsm.h"
+#include "hsm_post.h"
+#include "hsm_uring.h"
+
+/*
+ *  --------------------- DEFINITION ---------------------
+ */
+
+//! Returns pointer to the member of ring at the given offset.
+#define RING_MEMBER(ring, offset)     ((uint32_t*)((uint8_t*)(ring) + (offset)))
+
+/*
+ *  --------------------- FUNCTION BODY ---------------------
+ */
+
+/** \brief Initialize the io_uring adapter.
+ *
+ * \param pAdapter uring_adapter_t* const           adapter to initialize
+ * \param entries uint32_t                          number of submission queue entries
+ * \param pState_Machine[] state_machine_t* const   array of state machines in priority order
+ * \param quantity uint32_t                         number of state machines
+ * \param pResults int32_t* const                   array to store the result of completions, one per state machine. It can be NULL.
+ *                                                  Not used for state machines with event queue, see uring_dispatch.
+ * \param eventFd int                               eventfd signalled on each completion, e.g. Event_Fd of linux_runtime_t.
+ *                                                  -1 if not required.
+ * \return int io_uring file descriptor or -1 on error.
+ *
+ */
+int init_uring(uring_adapter_t* const pAdapter,
+               uint32_t entries,
+               state_machine_t* const pState_Machine[],
+               uint32_t quantity,
+               int32_t* const pResults,
+               int eventFd)
+{
+  struct io_uring_params params;
+
+  memset(pAdapter, 0, sizeof(*pAdapter));
+  memset(&params, 0, sizeof(params));
+  pAdapter->State_Machines = pState_Machine;
+  pAdapter->Quantity = quantity;
+  pAdapter->Results = pResults;
+  pAdapter->Sq_Ring = MAP_FAILED;
+  pAdapter->Cq_Ring = MAP_FAILED;
+  pAdapter->Sqes = MAP_FAILED;
+
+  pAdapter->Fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+  if(pAdapter->Fd < 0)
+  {
+    return -1;
+  }
+
+  pAdapter->Entries = params.sq_entries;
+  pAdapter->Sq_Ring_Size = params.sq_off.array + (params.sq_entries * sizeof(uint32_t));
+  pAdapter->Cq_Ring_Size = params.cq_off.cqes + (params.cq_entries * sizeof(struct io_uring_cqe));
+  if(params.features & IORING_FEAT_SINGLE_MMAP)
+  {
+    if(pAdapter->Cq_Ring_Size > pAdapter->Sq_Ring_Size)
+    {
+      pAdapter->Sq_Ring_Size = pAdapter->Cq_Ring_Size;
+    }
+    pAdapter->Cq_Ring_Size = pAdapter->Sq_Ring_Size;
+  }
+
+  pAdapter->Sq_Ring = mmap(NULL, pAdapter->Sq_Ring_Size, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_POPULATE, pAdapter->Fd, IORING_OFF_SQ_RING);
+  if(pAdapter->Sq_Ring == MAP_FAILED)
+  {
+    close_uring(pAdapter);
+    return -1;
+  }
+
+  if(params.features & IORING_FEAT_SINGLE_MMAP)
+  {
+    pAdapter->Cq_Ring = pAdapter->Sq_Ring;
+  }
+  else
+  {
+    pAdapter->Cq_Ring = mmap(NULL, pAdapter->Cq_Ring_Size, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE, pAdapter->Fd, IORING_OFF_CQ_RING);
+  }
+
+  pAdapter->Sqes = mmap(NULL, params.sq_entries * sizeof(struct io_uring_sqe), PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, pAdapter->Fd, IORING_OFF_SQES);
+  if((pAdapter->Cq_Ring == MAP_FAILED) || (pAdapter->Sqes == MAP_FAILED))
+  {
+    close_uring(pAdapter);
+    return -1;
+  }
+
+  pAdapter->Sq_Head = RING_MEMBER(pAdapter->Sq_Ring, params.sq_off.head);
+  pAdapter->Sq_Tail = RING_MEMBER(pAdapter->Sq_Ring, params.sq_off.tail);
+  pAdapter->Sq_Array = RING_MEMBER(pAdapter->Sq_Ring, params.sq_off.array);
+  pAdapter->Sq_Mask = *RING_MEMBER(pAdapter->Sq_Ring, params.sq_off.ring_mask);
+  pAdapter->Sq_Local_Tail = *pAdapter->Sq_Tail;
+
+  pAdapter->Cq_Head = RING_MEMBER(pAdapter->Cq_Ring, params.cq_off.head);
+  pAdapter->Cq_Tail = RING_MEMBER(pAdapter->Cq_Ring, params.cq_off.tail);
+  pAdapter->Cq_Mask = *RING_MEMBER(pAdapter->Cq_Ring, params.cq_off.ring_mask);
+  pAdapter->Cqes = (struct io_uring_cqe*)((uint8_t*)pAdapter->Cq_Ring + params.cq_off.cqes);
+
+  if(eventFd >= 0)
+  {
+    if(syscall(__NR_io_uring_register, pAdapter->Fd, IORING_REGISTER_EVENTFD, &eventFd, 1) < 0)
+    {
+      close_uring(pAdapter);
+      return -1;
+    }
+  }
+  return pAdapter->Fd;
+}
+
+/** \brief Unmap the rings and close the io_uring.
+ *
+ * \param pAdapter uring_adapter_t* const   adapter
+ *
+ */
+void close_uring(uring_adapter_t* const pAdapter)
+{
+  if(pAdapter->Sqes != MAP_FAILED)
+  {
+    munmap(pAdapter->Sqes, pAdapter->Entries * sizeof(struct io_uring_sqe));
+  }
+  if((pAdapter->Cq_Ring != MAP_FAILED) && (pAdapter->Cq_Ring != pAdapter->Sq_Ring))
+  {
+    munmap(pAdapter->Cq_Ring, pAdapter->Cq_Ring_Size);
+  }
+  if(pAdapter->Sq_Ring != MAP_FAILED)
+  {
+    munmap(pAdapter->Sq_Ring, pAdapter->Sq_Ring_Size);
+  }
+  if(pAdapter->Fd >= 0)
+  {
+    close(pAdapter->Fd);
+  }
+
+  pAdapter->Sqes = MAP_FAILED;
+  pAdapter->Cq_Ring = MAP_FAILED;
+  pAdapter->Sq_Ring = MAP_FAILED;
+  pAdapter->Fd = -1;
+}
+
+/** \brief Get a free submission queue entry. The completion of request posts the event to state machine.
+ *  The user fills the request (opcode, fd, addr, ...) except user_data. Call it only from the dispatcher thread.
+ *
+ * \param pAdapter uring_adapter_t* const   adapter
+ * \param machine uint32_t                  index of state machine in the array passed to init_uring
+ * \param event uint32_t                    event to post on completion
+ * \return struct io_uring_sqe*             submission queue entry or NULL if queue is full.
+ *
+ */
+struct io_uring_sqe* uring_get_sqe(uring_adapter_t* const pAdapter,
+                                   uint32_t machine,
+                                   uint32_t event)
+{
+  const uint32_t tail = pAdapter->Sq_Local_Tail;
+  if((tail - HSM_LOAD_ACQUIRE(pAdapter->Sq_Head)) >= pAdapter->Entries)
+  {
+    return NULL;
+  }
+
+  const uint32_t index = tail & pAdapter->Sq_Mask;
+  struct io_uring_sqe* const pSqe = &pAdapter->Sqes[index];
+  memset(pSqe, 0, sizeof(*pSqe));
+  pSqe->user_data = URING_USER_DATA(machine, event);
+  pAdapter->Sq_Array[index] = index;
+  pAdapter->Sq_Local_Tail = tail + 1;
+  return pSqe;
+}
+
+/** \brief Submit all the prepared requests with single system call.
+ *
+ * \param pAdapter uring_adapter_t* const   adapter
+ * \param waitCompletions uint32_t          minimum number of completions to wait for. 0: don't wait.
+ * \return int number of requests submitted or -1 on error.
+ *
+ */
+int uring_submit(uring_adapter_t* const pAdapter, uint32_t waitCompletions)
+{
+  const uint32_t submit = pAdapter->Sq_Local_Tail - *pAdapter->Sq_Tail;
+  HSM_STORE_RELEASE(pAdapter->Sq_Tail, pAdapter->Sq_Local_Tail);
+
+  return (int)syscall(__NR_io_uring_enter, pAdapter->Fd, submit, waitCompletions,
+                      (waitCompletions != 0) ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+}
+
+/** \brief Post the events of completed requests to state machines and dispatch them.
+ *  Completions are drained in batches. When target state machine has a pending event,
+ *  the batch is dispatched before posting the remaining completions.
+ *  The completion of state machine with event queue is queued, its result (cqe res)
+ *  is the payload of event, see get_event_payload.
+ *
+ * \param pAdapter uring_adapter_t* const   adapter
+ * \return state_machine_result_t           result of dispatch_event
+ *
+ */
+state_machine_result_t uring_dispatch(uring_adapter_t* const pAdapter
+#if STATE_MACHINE_LOGGER
+                                      ,state_machine_event_logger event_logger
+                                      ,state_machine_result_logger result_logger
+#endif // STATE_MACHINE_LOGGER
+                                      )
+{
+  state_machine_result_t result = EVENT_HANDLED;
+  uint32_t head = *pAdapter->Cq_Head;   // Only the dispatcher updates head.
+
+  do
+  {
+    const uint32_t tail = HSM_LOAD_ACQUIRE(pAdapter->Cq_Tail);
+    if(head == tail)
+    {
+      break;
+    }
+
+    for(; head != tail; head++)
+    {
+      const struct io_uring_cqe* const pCqe = &pAdapter->Cqes[head & pAdapter->Cq_Mask];
+      const uint32_t machine = (uint32_t)(pCqe->user_data >> 32);
+      if(machine >= pAdapter->Quantity)
+      {
+        continue;   // Not submitted through uring_get_sqe.
+      }
+
+      state_machine_t* const pState_Machine = pAdapter->State_Machines[machine];
+#if HSM_EVENT_QUEUE
+      if(pState_Machine->Queue != NULL)
+      {
+        // Each completion is queued with its own result, Results would be overwritten
+        // by the next completion of the same state machine.
+        if(!post_event_payload(pState_Machine, (uint32_t)pCqe->user_data, (uint32_t)pCqe->res, NULL))
+        {
+          break;    // Queue is full, dispatch the current batch before posting further.
+        }
+        continue;
+      }
+#endif // HSM_EVENT_QUEUE
+
+      // State machine without queue accepts only one pending event, hence
+      // the next completion of it is posted after the batch is dispatched.
+      if(!post_event(pState_Machine, (uint32_t)pCqe->user_data, NULL))
+      {
+        break;    // Dispatch the current batch, before posting further.
+      }
+      if(pAdapter->Results != NULL)
+      {
+        pAdapter->Results[machine] = pCqe->res;
+      }
+    }
+    // Release the consumed entries to the kernel.
+    HSM_STORE_RELEASE(pAdapter->Cq_Head, head);
+
+    result = dispatch_event(pAdapter->State_Machines, pAdapter->Quantity
+#if STATE_MACHINE_LOGGER
+                            ,event_logger, result_logger
+#endif // STATE_MACHINE_LOGGER
+                            );
+  }while(result == EVENT_HANDLED);
+
+  return result;
+}
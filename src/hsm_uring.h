@@ -0,0 +1,99 @@
+/**
+ * \file
+ * \brief io_uring event source of state machines.
+ *
+ *  The user_data of each submitted request carries the index of target state machine
+ *  and the event to post. uring_dispatch maps the completion queue entries directly into
+ *  events of state machines and dispatches them in batches, without any thread hop
+ *  or system call per completion. It uses raw system calls, liburing is not required.
+
+ * \author  Nandkishor Biradar
+ * \date    19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+#ifndef HSM_URING_H
+#define HSM_URING_H
+
+#include <stddef.h>
+#include <linux/io_uring.h>
+
+/*
+ *  --------------------- DEFINITION ---------------------
+ */
+
+//! user_data of submission queue entry to post the event to state machine on completion.
+#define URING_USER_DATA(machine, event)   (((uint64_t)(machine) << 32) | (uint32_t)(event))
+
+/*
+ *  --------------------- STRUCTURE ---------------------
+ */
+
+//! io_uring adapter
+typedef struct
+{
+  int Fd;                               //!< io_uring file descriptor
+  void* Sq_Ring;                        //!< Mapping of submission queue ring
+  void* Cq_Ring;                        //!< Mapping of completion queue ring. Same as Sq_Ring for single mmap.
+  size_t Sq_Ring_Size;                  //!< Size of submission queue ring mapping
+  size_t Cq_Ring_Size;                  //!< Size of completion queue ring mapping
+  struct io_uring_sqe* Sqes;            //!< Array of submission queue entries
+  uint32_t Entries;                     //!< Number of submission queue entries
+
+  uint32_t* Sq_Head;                    //!< Head of submission queue, updated by kernel
+  uint32_t* Sq_Tail;                    //!< Tail of submission queue
+  uint32_t* Sq_Array;                   //!< Indirection array of submission queue
+  uint32_t Sq_Mask;                     //!< Ring mask of submission queue
+  uint32_t Sq_Local_Tail;               //!< Tail including entries not yet submitted
+
+  uint32_t* Cq_Head;                    //!< Head of completion queue
+  uint32_t* Cq_Tail;                    //!< Tail of completion queue, updated by kernel
+  struct io_uring_cqe* Cqes;            //!< Array of completion queue entries
+  uint32_t Cq_Mask;                     //!< Ring mask of completion queue
+
+  state_machine_t* const* State_Machines; //!< Array of state machines in priority order
+  uint32_t Quantity;                    //!< Number of state machines
+  int32_t* Results;                     //!< Result (cqe res) of the pending event of each state machine without event queue.
+                                        //!< State machine with queue gets it as payload of event. It can be NULL.
+}uring_adapter_t;
+
+/*
+ *  --------------------- EXPORTED FUNCTION ---------------------
+ */
+
+#ifdef __cplusplus
+extern "C"  {
+#endif // __cplusplus
+
+extern int init_uring(uring_adapter_t* const pAdapter,
+                      uint32_t entries,
+                      state_machine_t* const pState_Machine[],
+                      uint32_t quantity,
+                      int32_t* const pResults,
+                      int eventFd);
+
+extern void close_uring(uring_adapter_t* const pAdapter);
+
+extern struct io_uring_sqe* uring_get_sqe(uring_adapter_t* const pAdapter,
+                                          uint32_t machine,
+                                          uint32_t event);
+
+extern int uring_submit(uring_adapter_t* const pAdapter, uint32_t waitCompletions);
+
+extern state_machine_result_t uring_dispatch(uring_adapter_t* const pAdapter
+#if STATE_MACHINE_LOGGER
+                                             ,state_machine_event_logger event_logger
+                                             ,state_machine_result_logger result_logger
+#endif // STATE_MACHINE_LOGGER
+                                             );
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // HSM_URING_H
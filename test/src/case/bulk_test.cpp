@@ -0,0 +1,136 @@
+/**
+ * \file
+ * \brief Bulk transition engine test
+
+ * \author  Nandkishor Biradar
+ * \date  19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+#include "catch.hpp"
+
+#include <stdint.h>
+#include "hsm_bulk.h"
+
+namespace bulk_test
+{
+
+enum
+{
+  IDLE,
+  ACTIVE,
+  UPDATING,
+  TOTAL_STATES
+};
+
+enum
+{
+  EN_START,
+  EN_ROLLOUT,
+  TOTAL_EVENTS
+};
+
+const uint16_t Transition[TOTAL_EVENTS * TOTAL_STATES] =
+{
+  // EN_START
+  ACTIVE,   ACTIVE,   UPDATING,
+  // EN_ROLLOUT
+  IDLE,     UPDATING, UPDATING,
+};
+
+const uint32_t INSTANCES = 37;    // Not a multiple of SIMD lanes
+uint32_t Entry_Count[INSTANCES];
+uint32_t Exit_Count[INSTANCES];
+
+void active_entry(uint32_t instance)
+{
+  Entry_Count[instance]++;
+}
+
+void active_exit(uint32_t instance)
+{
+  Exit_Count[instance]++;
+}
+
+const bulk_action Entry[TOTAL_STATES] = {NULL, active_entry, NULL};
+const bulk_action Exit[TOTAL_STATES] = {NULL, active_exit, NULL};
+
+const bulk_state_table_t Table =
+{
+  Transition,
+  Entry,
+  Exit,
+  TOTAL_STATES,
+  TOTAL_EVENTS
+};
+
+SCENARIO("Bulk transition of flat state machines")
+{
+#ifdef BULK_TEST_ISA
+  // Engine is compiled for the instruction set of this test.
+  if(!__builtin_cpu_supports(BULK_TEST_ISA))
+  {
+    WARN("CPU doesn't support " BULK_TEST_ISA ", test is skipped");
+    return;
+  }
+#endif // BULK_TEST_ISA
+
+  GIVEN("Instances in idle and updating states")
+  {
+    uint16_t state[INSTANCES];
+    for(uint32_t index = 0; index < INSTANCES; index++)
+    {
+      state[index] = (index % 3 == 0) ? UPDATING : IDLE;
+      Entry_Count[index] = 0;
+      Exit_Count[index] = 0;
+    }
+
+    WHEN("Start event is applied to all the instances")
+    {
+      uint32_t changed = bulk_dispatch_event(&Table, state, INSTANCES, EN_START);
+
+      THEN("Only idle instances enter the active state")
+      {
+        uint32_t expected = 0;
+        for(uint32_t index = 0; index < INSTANCES; index++)
+        {
+          if(index % 3 == 0)
+          {
+            REQUIRE(state[index] == UPDATING);
+            REQUIRE(Entry_Count[index] == 0);
+          }
+          else
+          {
+            expected++;
+            REQUIRE(state[index] == ACTIVE);
+            REQUIRE(Entry_Count[index] == 1);
+          }
+          REQUIRE(Exit_Count[index] == 0);
+        }
+        REQUIRE(changed == expected);
+      }
+
+      AND_WHEN("Rollout event is applied to all the instances")
+      {
+        uint32_t updated = bulk_dispatch_event(&Table, state, INSTANCES, EN_ROLLOUT);
+
+        THEN("Active instances exit the active state")
+        {
+          for(uint32_t index = 0; index < INSTANCES; index++)
+          {
+            REQUIRE(state[index] == UPDATING);
+            REQUIRE(Exit_Count[index] == ((index % 3 == 0) ? 0u : 1u));
+          }
+          REQUIRE(updated == changed);
+        }
+      }
+    }
+  }
+}
+
+}
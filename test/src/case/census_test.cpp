@@ -0,0 +1,217 @@
+/**
+ * \file
+ * \brief Test of census of state machines in each state
+
+ * \author  Nandkishor Biradar
+ * \date  19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+#include <cstdint>
+#include <thread>
+
+#include "catch.hpp"
+
+#include "hsm.h"
+#include "hsm_post.h"
+#include "hsm_pool.h"
+#include "hsm_hibernate.h"
+
+namespace census_test
+{
+
+state_machine_result_t handler(state_machine_t * const)
+{
+  return EVENT_HANDLED;
+}
+
+extern const state_t Child_HSM[2];
+
+const state_t Root_HSM[2] =
+{
+  {
+    handler,
+    NULL,
+    NULL,
+    0,
+    NULL,
+    NULL,
+    0
+  },
+  {
+    handler,
+    NULL,
+    NULL,
+    1,
+    NULL,
+    Child_HSM,
+    0
+  }
+};
+
+const state_t Child_HSM[2] =
+{
+  {
+    handler,
+    NULL,
+    NULL,
+    2,
+    &Root_HSM[1],
+    NULL,
+    1
+  },
+  {
+    handler,
+    NULL,
+    NULL,
+    3,
+    &Root_HSM[1],
+    NULL,
+    1
+  }
+};
+
+const uint32_t CAPACITY = 4;
+alignas(HSM_POOL_CACHE_LINE) uint8_t Memory[MACHINE_POOL_SIZE(sizeof(state_machine_t), CAPACITY)];
+uint8_t Cold_Memory[COLD_STORE_SIZE(0, CAPACITY)];
+
+uint32_t get_now(void)
+{
+  return 0;
+}
+
+SCENARIO("Census of state machines")
+{
+  GIVEN( "State machines counted in census" )
+  {
+    state_machine_t machine1 = {}, machine2 = {};
+    uint32_t before[4], after[4];
+    get_census(before, 4);
+
+    set_state(&machine1, &Root_HSM[0]);
+    set_state(&machine2, &Root_HSM[0]);
+    census_add(&machine1);
+    census_add(&machine2);
+    bool counted = true;
+
+    WHEN( "state machines transition in different threads" )
+    {
+      state_machine_t machine = {};
+      std::thread worker([&machine]()
+      {
+        set_state(&machine, &Root_HSM[1]);
+        census_add(&machine);
+        for(uint32_t count = 0; count < 1000; count++)
+        {
+          switch_state(&machine, &Child_HSM[1]);
+          switch_state(&machine, &Root_HSM[1]);
+        }
+        switch_state(&machine, &Child_HSM[1]);
+      });
+      switch_state(&machine1, &Root_HSM[1]);
+      worker.join();
+
+      THEN( "census has the number of state machines in each state" )
+      {
+        get_census(after, 4);
+        REQUIRE(after[0] - before[0] == 1);
+        REQUIRE(after[1] - before[1] == 1);
+        REQUIRE(after[2] - before[2] == 0);
+        REQUIRE(after[3] - before[3] == 1);
+      }
+
+      // Sum of shards is the count, hence it can be removed from any thread.
+      census_remove(&machine);
+    }
+
+    WHEN( "state machine is removed from census" )
+    {
+      census_remove(&machine2);
+      counted = false;
+
+      THEN( "it is not counted" )
+      {
+        get_census(after, 4);
+        REQUIRE(after[0] - before[0] == 1);
+      }
+    }
+
+    census_remove(&machine1);
+    if(counted)
+    {
+      census_remove(&machine2);
+    }
+    get_census(after, 4);
+    REQUIRE(after[0] == before[0]);
+    REQUIRE(after[1] == before[1]);
+    REQUIRE(after[3] == before[3]);
+  }
+
+  GIVEN( "State machines created from pool" )
+  {
+    machine_pool_t pool;
+    state_machine_t* machines[CAPACITY];
+    uint32_t before[4], after[4];
+    get_census(before, 4);
+    REQUIRE(init_machine_pool(&pool, Memory, sizeof(state_machine_t), CAPACITY));
+    REQUIRE(create_machines(&pool, machines, CAPACITY, &Root_HSM[0]) == CAPACITY);
+
+    WHEN( "pool is reset after some instances are destroyed" )
+    {
+      destroy_machine(&pool, machines[1]);
+      switch_state(machines[2], &Root_HSM[1]);
+      reset_machine_pool(&pool);
+
+      THEN( "live instances are removed from the census" )
+      {
+        get_census(after, 4);
+        REQUIRE(after[0] == before[0]);
+        REQUIRE(after[1] == before[1]);
+      }
+    }
+  }
+
+  GIVEN( "State machines in a store" )
+  {
+    machine_pool_t pool;
+    machine_store_t store;
+    uint32_t location[CAPACITY], lastActive[CAPACITY];
+    uint32_t before[4], after[4];
+    get_census(before, 4);
+    REQUIRE(init_machine_pool(&pool, Memory, sizeof(state_machine_t), CAPACITY));
+    REQUIRE(init_machine_store(&store, &pool, Cold_Memory, CAPACITY, 0, location, lastActive, CAPACITY, get_now));
+    REQUIRE(store_create_machine(&store, 0, &Root_HSM[0]) != NULL);
+    switch_state(store_create_machine(&store, 1, &Root_HSM[0]), &Child_HSM[1]);
+
+    WHEN( "they are hibernated" )
+    {
+      REQUIRE(hibernate_machine(&store, 0));
+      REQUIRE(hibernate_machine(&store, 1));
+
+      THEN( "census counts them in their state until they are destroyed" )
+      {
+        get_census(after, 4);
+        REQUIRE(after[0] - before[0] == 1);
+        REQUIRE(after[3] - before[3] == 1);
+
+        REQUIRE(wake_machine(&store, 1) != NULL);
+        get_census(after, 4);
+        REQUIRE(after[0] - before[0] == 1);
+        REQUIRE(after[3] - before[3] == 1);
+      }
+    }
+
+    store_destroy_machine(&store, 0);
+    store_destroy_machine(&store, 1);
+    get_census(after, 4);
+    REQUIRE(after[0] == before[0]);
+    REQUIRE(after[3] == before[3]);
+  }
+}
+
+}
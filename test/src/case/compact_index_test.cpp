@@ -0,0 +1,79 @@
+/**
+ * \file
+ * \brief Test of broadcast to compact state machines
+
+ * \author  Nandkishor Biradar
+ * \date  19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+#include <cstdint>
+
+#include "catch.hpp"
+
+#include "hsm.h"
+
+namespace compact_index_test
+{
+
+state_machine_t Machine;
+
+state_machine_result_t handler(state_machine_t * const)
+{
+  return EVENT_HANDLED;
+}
+
+const state_t Idle_State =
+{
+  handler,
+  NULL,
+  NULL,
+  0,
+  NULL,
+  NULL,
+  0
+};
+
+}
+
+//! Table of all the states used by compact state machine.
+extern "C" const state_t* const State_Table[] =
+{
+  &compact_index_test::Idle_State,
+};
+
+namespace compact_index_test
+{
+
+SCENARIO("Broadcast to compact state machines")
+{
+  GIVEN( "A compact state machine in the index" )
+  {
+    state_machine_t* found[1];
+    set_state(&Machine, &Idle_State);
+    Machine.Event = 0;
+    index_add(&Machine);
+
+    WHEN( "event above UINT16_MAX is broadcast" )
+    {
+      const uint32_t posted = broadcast_event(&Idle_State, UINT16_MAX + 1u, found, 1);
+
+      THEN( "it is not posted instead of truncated" )
+      {
+        REQUIRE(posted == 0);
+        REQUIRE(Machine.Event == 0);
+        REQUIRE(broadcast_event(&Idle_State, UINT16_MAX, found, 1) == 1);
+        REQUIRE(Machine.Event == UINT16_MAX);
+      }
+    }
+
+    index_remove(&Machine);
+  }
+}
+
+}
@@ -0,0 +1,196 @@
+/**
+ * \file
+ * \brief Compact state machine test
+
+ * \author  Nandkishor Biradar
+ * \date  19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+#include "catch.hpp"
+#define _HIPPOMOCKS__ENABLE_CFUNC_MOCKING_SUPPORT
+#include "hippomocks.h"
+
+#include "hsm.h"
+#include "hsm_post.h"
+#include "hsm_record.h"
+
+namespace compact_test
+{
+
+state_machine_result_t root_handler(state_machine_t * const)
+{
+  return EVENT_HANDLED;
+}
+state_machine_result_t child_handler(state_machine_t * const)
+{
+  return EVENT_HANDLED;
+}
+state_machine_result_t root_exit_handler(state_machine_t * const)
+{
+  return EVENT_HANDLED;
+}
+state_machine_result_t child_entry_handler(state_machine_t * const)
+{
+  return EVENT_HANDLED;
+}
+
+extern const state_t Child_HSM[2];
+
+const state_t Root_HSM[2] =
+{
+  {
+    root_handler,
+    NULL,
+    root_exit_handler,
+    0,
+    NULL,
+    NULL,
+    0
+  },
+  {
+    root_handler,
+    NULL,
+    NULL,
+    1,
+    NULL,
+    Child_HSM,
+    0
+  }
+};
+
+const state_t Child_HSM[2] =
+{
+  {
+    child_handler,
+    child_entry_handler,
+    NULL,
+    2,
+    &Root_HSM[1],
+    NULL,
+    1
+  },
+  {
+    child_handler,
+    NULL,
+    NULL,
+    3,
+    &Root_HSM[1],
+    NULL,
+    1
+  }
+};
+
+}
+
+//! Table of all the states used by compact state machine.
+extern "C" const state_t* const State_Table[] =
+{
+  &compact_test::Root_HSM[0],
+  &compact_test::Root_HSM[1],
+  &compact_test::Child_HSM[0],
+  &compact_test::Child_HSM[1],
+};
+
+namespace compact_test
+{
+
+SCENARIO("Compact state machine")
+{
+  GIVEN( "A compact state machine" )
+  {
+    state_machine_t machine;
+    state_machine_t * const machineList[] = {&machine};
+    set_state(&machine, &Root_HSM[0]);
+
+    THEN("State machine header is 4 bytes")
+    {
+      REQUIRE(sizeof(state_machine_t) == 4);
+    }
+
+    WHEN("State transition using \"traverse_state\"")
+    {
+      MockRepository mocks;
+      mocks.ExpectCallFunc(root_exit_handler).With(&machine).Return(EVENT_HANDLED);
+      mocks.ExpectCallFunc(child_entry_handler).With(&machine).Return(EVENT_HANDLED);
+
+      THEN("It stores the index of target state")
+      {
+        REQUIRE(traverse_state(&machine, &Child_HSM[0]) == EVENT_HANDLED);
+        REQUIRE(machine.State == 2);
+        REQUIRE(get_state(&machine) == &Child_HSM[0]);
+      }
+    }
+
+    WHEN("Child state couldn't handle the event")
+    {
+      set_state(&machine, &Child_HSM[1]);
+      machine.Event = 1;
+
+      MockRepository mocks;
+      mocks.ExpectCallFunc(child_handler).With(&machine).Return(EVENT_UN_HANDLED);
+      mocks.ExpectCallFunc(root_handler).With(&machine).Return(EVENT_HANDLED);
+
+      THEN("dispatch_event invokes the parent handler")
+      {
+        REQUIRE(dispatch_event(machineList, 1) == EVENT_HANDLED);
+        REQUIRE(machine.Event == 0);
+        REQUIRE(get_state(&machine) == &Child_HSM[1]);
+      }
+    }
+  }
+}
+
+uint32_t get_ticks(void)
+{
+  return 0;
+}
+
+SCENARIO("Events out of range of compact state machine")
+{
+  GIVEN( "A compact state machine" )
+  {
+    state_machine_t machine;
+    state_machine_t * const machineList[] = {&machine};
+    set_state(&machine, &Root_HSM[0]);
+    machine.Event = 0;
+
+    WHEN( "event above UINT16_MAX is posted" )
+    {
+      THEN( "it is rejected instead of truncated" )
+      {
+        REQUIRE_FALSE(is_event_in_range(UINT16_MAX + 1u));
+        REQUIRE_FALSE(post_event(&machine, UINT16_MAX + 1u, NULL));
+        REQUIRE_FALSE(post_event_from_isr(&machine, UINT16_MAX + 2u, 0));
+        REQUIRE(machine.Event == 0);
+
+        REQUIRE(post_event(&machine, UINT16_MAX, NULL));
+        REQUIRE(machine.Event == UINT16_MAX);
+      }
+    }
+
+    WHEN( "recording with event above UINT16_MAX is replayed" )
+    {
+      event_recorder_t recorder;
+      event_record_t log[2];
+      replay_report_t report;
+      init_recorder(&recorder, log, 2, get_ticks, NULL, 0);
+      REQUIRE(record_event(&recorder, 0, UINT16_MAX + 1u));
+      REQUIRE(record_event(&recorder, 0, 1));
+
+      THEN( "the event is rejected" )
+      {
+        REQUIRE(replay_events(&recorder, machineList, 1, NULL, &report) == EVENT_HANDLED);
+        REQUIRE(report.Events == 1);
+        REQUIRE(report.Rejected == 1);
+      }
+    }
+  }
+}
+
+}
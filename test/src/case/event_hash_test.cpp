@@ -0,0 +1,84 @@
+/**
+ * \file
+ * \brief Test of perfect hash of event names generated by hsm_event_hash
+
+ * \author  Nandkishor Biradar
+ * \date  19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+#include <cstdint>
+#include <cstring>
+
+#include "catch.hpp"
+
+#include "event_hash_test.h"
+#include "hash_event_hash.h"
+
+namespace event_hash_test
+{
+
+uint32_t decode(const char* const pName)
+{
+  return decode_hash_event(pName, strlen(pName));
+}
+
+SCENARIO("Decode event names using perfect hash")
+{
+  GIVEN( "Names generated from hash_event_t" )
+  {
+    REQUIRE(HASH_EVENT_NAMES == 16);
+
+    THEN( "each name is decoded to its event" )
+    {
+      REQUIRE(decode("start") == EV_START);
+      REQUIRE(decode("stop") == EV_STOP);
+      REQUIRE(decode("pause") == EV_PAUSE);
+      REQUIRE(decode("resume") == EV_RESUME);
+      REQUIRE(decode("door_open") == EV_DOOR_OPEN);
+      REQUIRE(decode("door_close") == EV_DOOR_CLOSE);
+      REQUIRE(decode("timeout") == EV_TIMEOUT);
+      REQUIRE(decode("heat") == EV_HEAT);
+      REQUIRE(decode("cool") == EV_COOL);
+      REQUIRE(decode("lamp_on") == EV_LAMP_ON);
+      REQUIRE(decode("lamp_off") == EV_LAMP_OFF);
+      REQUIRE(decode("fan_on") == EV_FAN_ON);
+      REQUIRE(decode("fan_off") == EV_FAN_OFF);
+      REQUIRE(decode("reset") == EV_RESET);
+      REQUIRE(decode("fault") == EV_FAULT);
+      REQUIRE(decode("a") == EV_A);
+    }
+
+    THEN( "every slot holds a distinct event" )
+    {
+      for(uint32_t slot = 0; slot < HASH_EVENT_NAMES; slot++)
+      {
+        REQUIRE(decode(Hash_Event_Name[slot]) == Hash_Event_Value[slot]);
+      }
+    }
+
+    THEN( "name is decoded from a buffer without terminator" )
+    {
+      const char buffer[] = "door_opened";
+      REQUIRE(decode_hash_event(buffer, 9) == EV_DOOR_OPEN);
+      REQUIRE(decode_hash_event(buffer, 4) == 0);
+    }
+
+    THEN( "unknown names are decoded to no event" )
+    {
+      REQUIRE(decode("") == 0);
+      REQUIRE(decode("START") == 0);
+      REQUIRE(decode("door") == 0);
+      REQUIRE(decode("total_events") == 0);
+      REQUIRE(decode("commented") == 0);
+      REQUIRE(decode("lamp_offf") == 0);
+    }
+  }
+}
+
+}
@@ -0,0 +1,44 @@
+#ifndef EVENT_HASH_TEST_H
+#define EVENT_HASH_TEST_H
+
+/**
+ * \file
+ * \brief Events of perfect hash test
+
+ * \author  Nandkishor Biradar
+ * \date    19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+/*
+ *  --------------------- ENUMERATION ---------------------
+ */
+
+//! List of events decoded by hsm_event_hash
+typedef enum
+{
+  EV_START = 1,
+  EV_STOP,
+  EV_PAUSE,
+  EV_RESUME,
+  EV_DOOR_OPEN,
+  EV_DOOR_CLOSE,
+  EV_TIMEOUT,   // , EV_COMMENTED
+  EV_HEAT = 16,
+  EV_COOL = (EV_HEAT + 1),
+  EV_LAMP_ON,
+  EV_LAMP_OFF,
+  EV_FAN_ON,
+  EV_FAN_OFF,
+  EV_RESET,
+  EV_FAULT,
+  EV_A,
+  TOTAL_EVENTS = EV_A,    //!< Not an event, it doesn't have the prefix
+}hash_event_t;
+
+#endif // EVENT_HASH_TEST_H
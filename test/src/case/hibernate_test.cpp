@@ -0,0 +1,209 @@
+/**
+ * \file
+ * \brief Test of hibernation of idle state machines
+
+ * \author  Nandkishor Biradar
+ * \date  19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+#include "catch.hpp"
+
+#include "hsm.h"
+#include "hsm_post.h"
+#include "hsm_pool.h"
+#include "hsm_hibernate.h"
+#if HSM_EVENT_RECORDER
+#include "hsm_record.h"
+#endif // HSM_EVENT_RECORDER
+
+namespace hibernate_test
+{
+
+//! User derived state machine
+struct oven_t
+{
+  state_machine_t Machine;
+  uint32_t Temperature;     //!< Kept in cold store
+  uint32_t Scratch;         //!< Cleared on rehydration
+};
+
+state_machine_result_t heat_handler(state_machine_t * const pState_Machine)
+{
+  reinterpret_cast<oven_t*>(pState_Machine)->Temperature++;
+  return EVENT_HANDLED;
+}
+
+const state_t Oven_State[2] =
+{
+  {
+    heat_handler,
+    NULL,
+    NULL,
+    #if HIERARCHICAL_STATES
+    NULL,
+    NULL,
+    0
+    #endif
+  },
+  {
+    heat_handler,
+    NULL,
+    NULL,
+    #if HIERARCHICAL_STATES
+    NULL,
+    NULL,
+    0
+    #endif
+  }
+};
+
+uint32_t Now;
+
+uint32_t get_now(void)
+{
+  return Now;
+}
+
+const uint32_t HOT = 2;
+const uint32_t MACHINES = 4;
+const size_t DATA_SIZE = offsetof(oven_t, Scratch) - sizeof(state_machine_t);
+alignas(HSM_POOL_CACHE_LINE) uint8_t Hot_Memory[MACHINE_POOL_SIZE(sizeof(oven_t), HOT)];
+uint8_t Cold_Memory[COLD_STORE_SIZE(DATA_SIZE, MACHINES)];
+
+SCENARIO("Hibernation of idle state machines")
+{
+  GIVEN( "A store of 4 instances with 2 hot slots" )
+  {
+    machine_pool_t pool;
+    machine_store_t store;
+    uint32_t location[MACHINES];
+    uint32_t lastActive[MACHINES];
+    Now = 100;
+
+    REQUIRE(init_machine_pool(&pool, Hot_Memory, sizeof(oven_t), HOT));
+    REQUIRE(init_machine_store(&store, &pool, Cold_Memory, MACHINES, DATA_SIZE,
+                               location, lastActive, MACHINES, get_now));
+    REQUIRE(COLD_RECORD_SIZE(DATA_SIZE) < pool.Slot_Size);
+
+    oven_t* const oven = reinterpret_cast<oven_t*>(store_create_machine(&store, 0, &Oven_State[0]));
+    REQUIRE(oven != NULL);
+    REQUIRE(store_create_machine(&store, 1, &Oven_State[0]) != NULL);
+    REQUIRE(store_create_machine(&store, 2, &Oven_State[0]) == NULL);
+
+    switch_state(&oven->Machine, &Oven_State[1]);
+    oven->Temperature = 180;
+    oven->Scratch = 7;
+
+    WHEN( "instances are idle" )
+    {
+      Now += 5;
+      REQUIRE(hibernate_idle(&store, 10, MACHINES) == 0);
+      Now += 5;
+      REQUIRE(hibernate_idle(&store, 10, MACHINES) == 2);
+
+      THEN( "they are moved to the cold store and their slots are released" )
+      {
+        REQUIRE(is_hibernated(&store, 0));
+        REQUIRE(is_hibernated(&store, 1));
+        REQUIRE(pool.Used == 0);
+        REQUIRE(store.Cold_Used == 2);
+        REQUIRE(store_create_machine(&store, 2, &Oven_State[0]) != NULL);
+      }
+
+      THEN( "posted event rehydrates the instance with its state and data" )
+      {
+        state_machine_t* const machine = post_to_store(&store, 0, 1, NULL);
+        REQUIRE(machine != NULL);
+        REQUIRE_FALSE(is_hibernated(&store, 0));
+        REQUIRE(store.Cold_Used == 1);
+        REQUIRE(get_state(machine) == &Oven_State[1]);
+        REQUIRE(machine->Event == 1);
+
+        oven_t* const woken = reinterpret_cast<oven_t*>(machine);
+        REQUIRE(woken->Temperature == 180);
+        REQUIRE(woken->Scratch == 0);
+
+        state_machine_t* const machines[] = {machine};
+        REQUIRE(dispatch_event(machines, 1) == EVENT_HANDLED);
+        REQUIRE(woken->Temperature == 181);
+
+        REQUIRE(hibernate_idle(&store, 10, MACHINES) == 0);
+      }
+
+      THEN( "woken instance is active from the time of rehydration" )
+      {
+        Now += 20;
+        REQUIRE(wake_machine(&store, 1) != NULL);
+        REQUIRE(lastActive[1] == Now);
+        REQUIRE(hibernate_idle(&store, 10, MACHINES) == 0);
+        REQUIRE_FALSE(is_hibernated(&store, 1));
+      }
+
+      THEN( "broadcast reaches the hibernated instances in the state" )
+      {
+        state_machine_t* const hot = store_create_machine(&store, 2, &Oven_State[1]);
+        REQUIRE(hot != NULL);
+        state_machine_t* machines[MACHINES];
+        REQUIRE(broadcast_to_store(&store, &Oven_State[1], 1, machines, MACHINES) == 2);
+        REQUIRE_FALSE(is_hibernated(&store, 0));
+        REQUIRE(is_hibernated(&store, 1));
+        REQUIRE(machines[1] == hot);
+        REQUIRE(dispatch_event(machines, 2) == EVENT_HANDLED);
+        REQUIRE(reinterpret_cast<oven_t*>(machines[0])->Temperature == 181);
+      }
+
+      THEN( "hibernated instance can be destroyed" )
+      {
+        store_destroy_machine(&store, 1);
+        REQUIRE(store.Cold_Used == 1);
+        REQUIRE(wake_machine(&store, 1) == NULL);
+        REQUIRE(post_to_store(&store, 1, 1, NULL) == NULL);
+      }
+    }
+
+#if HSM_EVENT_RECORDER
+    WHEN( "instance attached to a recorder is hibernated" )
+    {
+      event_recorder_t recorder;
+      event_record_t log[4];
+      init_recorder(&recorder, log, 4, get_now, NULL, 0);
+      attach_recorder(&oven->Machine, &recorder, 3);
+      REQUIRE(hibernate_machine(&store, 0));
+
+      THEN( "it is still attached once rehydrated" )
+      {
+        state_machine_t* const machine = post_to_store(&store, 0, 1, NULL);
+        REQUIRE(machine != NULL);
+        REQUIRE(machine->Recorder == &recorder);
+        REQUIRE(machine->Record_Index == 3);
+        REQUIRE(recorder.Count == 1);
+      }
+    }
+#endif // HSM_EVENT_RECORDER
+
+    WHEN( "instance has pending event" )
+    {
+      oven->Machine.Event = 1;
+      Now += 10;
+
+      THEN( "it is not hibernated" )
+      {
+        REQUIRE_FALSE(hibernate_machine(&store, 0));
+        REQUIRE(hibernate_idle(&store, 10, MACHINES) == 1);
+        REQUIRE_FALSE(is_hibernated(&store, 0));
+        REQUIRE(is_hibernated(&store, 1));
+      }
+    }
+  }
+}
+
+}
@@ -12,6 +12,9 @@
  *  file LICENSE or copy at https://mit-license.org/)
  */
 
+#include <future>
+#include <thread>
+
 #include "catch.hpp"
 #define _HIPPOMOCKS__ENABLE_CFUNC_MOCKING_SUPPORT
 #include "hippomocks.h"
@@ -233,7 +236,7 @@ SCENARIO("Transition from same level and same parent")
 {
   GIVEN( "A composite state machine" )
   {
-    state_machine_t machine;
+    state_machine_t machine = {};
     WHEN("Transition from Level3_Child1 to Level3_Child2")
     {
 
@@ -256,7 +259,7 @@ SCENARIO("Transition from same level and different parent states")
 {
   GIVEN( "A composite state machine" )
   {
-    state_machine_t machine;
+    state_machine_t machine = {};
     WHEN("Transition from Level3_Child3 to Level3_Child4")
     {
       AND_WHEN("any of entry handler triggers event to self")
@@ -302,7 +305,7 @@ SCENARIO("Transition from low level to high level states")
 {
   GIVEN( "A composite state machine" )
   {
-    state_machine_t machine;
+    state_machine_t machine = {};
     WHEN("Transition from Level3_Child3 to Level1_Child3")
     {
       machine.State = Level3_Child3_HSM;
@@ -360,7 +363,7 @@ SCENARIO("Transition from high level to low level states")
 {
   GIVEN( "A composite state machine" )
   {
-    state_machine_t machine;
+    state_machine_t machine = {};
     WHEN("Transition from Level1_Child3 to Level3_Child2")
     {
       machine.State = &Level1_HSM[2];
@@ -414,6 +417,242 @@ SCENARIO("Transition from high level to low level states")
   }
 }
 
+SCENARIO("Transition between ancestor and its substate")
+{
+  GIVEN( "A composite state machine" )
+  {
+    state_machine_t machine = {};
+    WHEN("External transition from Level1_Child1 to Level3_Child2")
+    {
+      machine.State = &Level1_HSM[0];
+
+      MockRepository mocks;
+      mocks.ExpectCallFunc(level1_child1_exit_handler).With(&machine).Return(EVENT_HANDLED);
+      mocks.ExpectCallFunc(level1_child1_entry_handler).With(&machine).Return(EVENT_HANDLED);
+      mocks.ExpectCallFunc(level2_child2_entry_handler).With(&machine).Return(EVENT_HANDLED);
+      mocks.ExpectCallFunc(level3_child2_entry_handler).With(&machine).Return(EVENT_HANDLED);
+
+      THEN("traverse_state exits and re-enters the source state")
+      {
+        REQUIRE((traverse_state(&machine, &Level3_Child1_HSM[1])) == EVENT_HANDLED);
+        REQUIRE(machine.State == &Level3_Child1_HSM[1]);
+      }
+    }
+
+    WHEN("Local transition from Level1_Child1 to Level3_Child2")
+    {
+      machine.State = &Level1_HSM[0];
+
+      MockRepository mocks;
+      mocks.ExpectCallFunc(level2_child2_entry_handler).With(&machine).Return(EVENT_HANDLED);
+      mocks.ExpectCallFunc(level3_child2_entry_handler).With(&machine).Return(EVENT_HANDLED);
+
+      THEN("traverse_state_local enters only the substates of source state")
+      {
+        REQUIRE((traverse_state_local(&machine, &Level3_Child1_HSM[1])) == EVENT_HANDLED);
+        REQUIRE(machine.State == &Level3_Child1_HSM[1]);
+      }
+    }
+
+    WHEN("Local transition from Level3_Child2 to Level1_Child1")
+    {
+      machine.State = &Level3_Child1_HSM[1];
+
+      MockRepository mocks;
+      mocks.ExpectCallFunc(level3_child2_exit_handler).With(&machine).Return(EVENT_HANDLED);
+      mocks.ExpectCallFunc(level2_child2_exit_handler).With(&machine).Return(TRIGGERED_TO_SELF);
+
+      THEN("traverse_state_local exits only the substates of target state")
+      {
+        REQUIRE((traverse_state_local(&machine, &Level1_HSM[0])) == TRIGGERED_TO_SELF);
+        REQUIRE(machine.State == &Level1_HSM[0]);
+      }
+    }
+
+    WHEN("Local transition from Level3_Child3 to Level3_Child4")
+    {
+      machine.State = Level3_Child3_HSM;
+
+      MockRepository mocks;
+      mocks.ExpectCallFunc(level3_child3_exit_handler).With(&machine).Return(EVENT_HANDLED);
+      mocks.ExpectCallFunc(level2_child3_exit_handler).With(&machine).Return(EVENT_HANDLED);
+      mocks.ExpectCallFunc(level2_child4_entry_handler).With(&machine).Return(EVENT_HANDLED);
+      mocks.ExpectCallFunc(level3_child4_entry_handler).With(&machine).Return(EVENT_HANDLED);
+
+      THEN("traverse_state_local is same as traverse_state")
+      {
+        REQUIRE((traverse_state_local(&machine, Level3_Child4_HSM)) == EVENT_HANDLED);
+        REQUIRE(machine.State == Level3_Child4_HSM);
+      }
+    }
+  }
 }
 
+#if HSM_TRANSITION_CACHE
+extern const state_t Sparse_Mid_HSM[];
+extern const state_t Sparse_Leaf_HSM[];
+
+//! Hierarchy with actions only at the top and bottom levels
+const state_t Sparse_Root_HSM[] =
+{
+  {
+    NULL,
+    level1_child1_entry_handler,
+    NULL,
+    NULL,
+    Sparse_Mid_HSM,
+    0
+  },
+  {
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    0
+  }
+};
+
+const state_t Sparse_Mid_HSM[] =
+{
+  {
+    NULL,
+    NULL,
+    NULL,
+    &Sparse_Root_HSM[0],
+    Sparse_Leaf_HSM,
+    1
+  }
+};
+
+const state_t Sparse_Leaf_HSM[] =
+{
+  {
+    NULL,
+    level3_child2_entry_handler,
+    level3_child2_exit_handler,
+    &Sparse_Mid_HSM[0],
+    NULL,
+    2
+  }
+};
 
+//! States without actions, to transition from other threads.
+const state_t Plain_HSM[2] =
+{
+  {
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    0
+  },
+  {
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    0
+  }
+};
+
+SCENARIO("Memoized transition")
+{
+  GIVEN( "A composite state machine with empty transition cache" )
+  {
+    state_machine_t machine = {};
+    transition_cache_stats_t stats;
+    clear_transition_cache();
+
+    WHEN("Same transition is repeated")
+    {
+      MockRepository mocks;
+      for(uint32_t count = 0; count < 2; count++)
+      {
+        mocks.ExpectCallFunc(level1_child1_exit_handler).With(&machine).Return(EVENT_HANDLED);
+        mocks.ExpectCallFunc(level1_child1_entry_handler).With(&machine).Return(EVENT_HANDLED);
+        mocks.ExpectCallFunc(level2_child2_entry_handler).With(&machine).Return(EVENT_HANDLED);
+        mocks.ExpectCallFunc(level3_child2_entry_handler).With(&machine).Return(EVENT_HANDLED);
+      }
+      mocks.ExpectCallFunc(level2_child2_entry_handler).With(&machine).Return(EVENT_HANDLED);
+      mocks.ExpectCallFunc(level3_child2_entry_handler).With(&machine).Return(EVENT_HANDLED);
+
+      THEN("cached sequence invokes the same entry and exit handlers")
+      {
+        machine.State = &Level1_HSM[0];
+        REQUIRE((traverse_state(&machine, &Level3_Child1_HSM[1])) == EVENT_HANDLED);
+        machine.State = &Level1_HSM[0];
+        REQUIRE((traverse_state(&machine, &Level3_Child1_HSM[1])) == EVENT_HANDLED);
+        REQUIRE(machine.State == &Level3_Child1_HSM[1]);
+
+        get_transition_cache_stats(&stats);
+        REQUIRE(stats.Misses == 1);
+        REQUIRE(stats.Hits == 1);
+
+        // Local transition between the same states is cached separately.
+        machine.State = &Level1_HSM[0];
+        REQUIRE((traverse_state_local(&machine, &Level3_Child1_HSM[1])) == EVENT_HANDLED);
+        get_transition_cache_stats(&stats);
+        REQUIRE(stats.Misses == 2);
+        REQUIRE(stats.Hits == 1);
+      }
+    }
+
+    WHEN("Transition passes through states without actions")
+    {
+      MockRepository mocks;
+      for(uint32_t count = 0; count < 2; count++)
+      {
+        mocks.ExpectCallFunc(level3_child2_exit_handler).With(&machine).Return(EVENT_HANDLED);
+        mocks.ExpectCallFunc(level1_child1_entry_handler).With(&machine).Return(EVENT_HANDLED);
+        mocks.ExpectCallFunc(level3_child2_entry_handler).With(&machine).Return(TRIGGERED_TO_SELF);
+      }
+
+      THEN("only the available actions are invoked")
+      {
+        machine.State = Sparse_Leaf_HSM;
+        for(uint32_t count = 0; count < 2; count++)
+        {
+          REQUIRE((traverse_state(&machine, &Sparse_Root_HSM[1])) == EVENT_HANDLED);
+          REQUIRE((traverse_state(&machine, Sparse_Leaf_HSM)) == TRIGGERED_TO_SELF);
+        }
+
+        get_transition_cache_stats(&stats);
+        REQUIRE(stats.Misses == 2);
+        REQUIRE(stats.Hits == 2);
+      }
+    }
+
+    WHEN("Cache is cleared while other thread has cached the transition")
+    {
+      std::promise<void> cached, cleared;
+      std::thread worker([&machine, &stats, &cached, &cleared]()
+      {
+        machine.State = &Plain_HSM[0];
+        traverse_state(&machine, &Plain_HSM[1]);
+        cached.set_value();
+        cleared.get_future().wait();
+
+        machine.State = &Plain_HSM[0];
+        traverse_state(&machine, &Plain_HSM[1]);
+        get_transition_cache_stats(&stats);
+      });
+
+      cached.get_future().wait();
+      clear_transition_cache();
+      cleared.set_value();
+      worker.join();
+
+      THEN("cache of the other thread is also cleared")
+      {
+        REQUIRE(stats.Misses == 2);
+        REQUIRE(stats.Hits == 0);
+      }
+    }
+  }
+}
+#endif // HSM_TRANSITION_CACHE
+
+}
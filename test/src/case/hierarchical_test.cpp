@@ -82,7 +82,7 @@ typedef enum
 
   GIVEN( "A composite state machine" )
   {
-    state_machine_t machine;
+    state_machine_t machine = {};
     state_machine_t * const machineList[] = {&machine};
     machine.State = child1HSM;
 
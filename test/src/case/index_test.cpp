@@ -0,0 +1,243 @@
+/**
+ * \file
+ * \brief Test of index of state machines in each state
+
+ * \author  Nandkishor Biradar
+ * \date  19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+#include <cstdint>
+
+#include "catch.hpp"
+
+#include "hsm.h"
+#include "hsm_post.h"
+#include "hsm_pool.h"
+#include "hsm_hibernate.h"
+
+namespace index_test
+{
+
+state_machine_result_t handler(state_machine_t * const)
+{
+  return EVENT_HANDLED;
+}
+
+extern const state_t Child_HSM[2];
+
+const state_t Root_HSM[2] =
+{
+  {
+    handler,
+    NULL,
+    NULL,
+    0,
+    NULL,
+    NULL,
+    0
+  },
+  {
+    handler,
+    NULL,
+    NULL,
+    1,
+    NULL,
+    Child_HSM,
+    0
+  }
+};
+
+const state_t Child_HSM[2] =
+{
+  {
+    handler,
+    NULL,
+    NULL,
+    2,
+    &Root_HSM[1],
+    NULL,
+    1
+  },
+  {
+    handler,
+    NULL,
+    NULL,
+    3,
+    &Root_HSM[1],
+    NULL,
+    1
+  }
+};
+
+const uint32_t CAPACITY = 4;
+alignas(HSM_POOL_CACHE_LINE) uint8_t Memory[MACHINE_POOL_SIZE(sizeof(state_machine_t), CAPACITY)];
+uint8_t Cold_Memory[COLD_STORE_SIZE(0, CAPACITY)];
+
+uint32_t get_now(void)
+{
+  return 0;
+}
+
+SCENARIO("Index of state machines in each state")
+{
+  GIVEN( "State machines added to the index" )
+  {
+    state_machine_t machine1, machine2, machine3;
+    state_machine_t* found[4];
+    set_state(&machine1, &Root_HSM[0]);
+    set_state(&machine2, &Root_HSM[0]);
+    set_state(&machine3, &Root_HSM[0]);
+    machine1.Event = machine2.Event = machine3.Event = 0;
+    index_add(&machine1);
+    index_add(&machine2);
+    index_add(&machine3);
+
+    REQUIRE(get_machines_in_state(&Root_HSM[0], found, 4) == 3);
+
+    WHEN( "state machines transition to other states" )
+    {
+      REQUIRE(traverse_state(&machine2, &Child_HSM[0]) == EVENT_HANDLED);
+      REQUIRE(switch_state(&machine3, &Child_HSM[0]) == EVENT_HANDLED);
+      REQUIRE(traverse_state(&machine3, &Child_HSM[1]) == EVENT_HANDLED);
+
+      THEN( "index lists only the state machines in the state" )
+      {
+        REQUIRE(get_machines_in_state(&Root_HSM[0], found, 4) == 1);
+        REQUIRE(found[0] == &machine1);
+        REQUIRE(get_machines_in_state(&Child_HSM[0], found, 4) == 1);
+        REQUIRE(found[0] == &machine2);
+        REQUIRE(get_machines_in_state(&Child_HSM[1], found, 4) == 1);
+        REQUIRE(found[0] == &machine3);
+        REQUIRE(get_machines_in_state(&Root_HSM[1], found, 4) == 0);
+      }
+    }
+
+    WHEN( "event is broadcast to a state" )
+    {
+      machine3.Event = 2;
+      const uint32_t posted = broadcast_event(&Root_HSM[0], 1, found, 4);
+
+      THEN( "it is posted to the state machines in the state that can accept it" )
+      {
+        REQUIRE(posted == 2);
+        REQUIRE(machine1.Event == 1);
+        REQUIRE(machine2.Event == 1);
+        REQUIRE(machine3.Event == 2);
+        REQUIRE(broadcast_event(&Child_HSM[0], 1, found, 4) == 0);
+      }
+    }
+
+    WHEN( "event is broadcast with smaller array" )
+    {
+      const uint32_t posted = broadcast_event(&Root_HSM[0], 1, found, 2);
+
+      THEN( "it is posted to at most the size of array" )
+      {
+        REQUIRE(posted == 2);
+        REQUIRE((machine1.Event + machine2.Event + machine3.Event) == 2);
+      }
+    }
+
+    WHEN( "state machine is removed from the index" )
+    {
+      index_remove(&machine2);
+
+      THEN( "it is not listed" )
+      {
+        REQUIRE(get_machines_in_state(&Root_HSM[0], found, 4) == 2);
+        REQUIRE(found[0] == &machine3);
+        REQUIRE(found[1] == &machine1);
+        index_add(&machine2);
+      }
+    }
+
+    index_remove(&machine1);
+    index_remove(&machine2);
+    index_remove(&machine3);
+  }
+
+  GIVEN( "State machines created from pool" )
+  {
+    machine_pool_t pool;
+    state_machine_t* machines[CAPACITY];
+    state_machine_t* found[CAPACITY];
+    REQUIRE(init_machine_pool(&pool, Memory, sizeof(state_machine_t), CAPACITY));
+    REQUIRE(create_machines(&pool, machines, CAPACITY, &Root_HSM[0]) == CAPACITY);
+
+    WHEN( "instances are destroyed" )
+    {
+      destroy_machine(&pool, machines[1]);
+      destroy_machine(&pool, machines[2]);
+
+      THEN( "index lists the live instances" )
+      {
+        REQUIRE(get_machines_in_state(&Root_HSM[0], found, CAPACITY) == 2);
+        REQUIRE(found[0] == machines[3]);
+        REQUIRE(found[1] == machines[0]);
+      }
+
+      destroy_machine(&pool, machines[0]);
+      destroy_machine(&pool, machines[3]);
+      REQUIRE(get_machines_in_state(&Root_HSM[0], found, CAPACITY) == 0);
+    }
+
+    WHEN( "pool is reset after some instances are destroyed" )
+    {
+      destroy_machine(&pool, machines[2]);
+      destroy_machine(&pool, machines[0]);
+      reset_machine_pool(&pool);
+
+      THEN( "live instances are removed from the index" )
+      {
+        REQUIRE(get_machines_in_state(&Root_HSM[0], found, CAPACITY) == 0);
+        REQUIRE(create_machine(&pool, &Root_HSM[1]) == machines[0]);
+        REQUIRE(get_machines_in_state(&Root_HSM[1], found, CAPACITY) == 1);
+      }
+      reset_machine_pool(&pool);
+    }
+  }
+
+  GIVEN( "State machines in a store" )
+  {
+    machine_pool_t pool;
+    machine_store_t store;
+    uint32_t location[CAPACITY], lastActive[CAPACITY];
+    state_machine_t* found[CAPACITY];
+    REQUIRE(init_machine_pool(&pool, Memory, sizeof(state_machine_t), CAPACITY));
+    REQUIRE(init_machine_store(&store, &pool, Cold_Memory, CAPACITY, 0, location, lastActive, CAPACITY, get_now));
+    REQUIRE(store_create_machine(&store, 0, &Root_HSM[0]) != NULL);
+    REQUIRE(store_create_machine(&store, 1, &Root_HSM[0]) != NULL);
+
+    WHEN( "one of them is hibernated" )
+    {
+      REQUIRE(hibernate_machine(&store, 0));
+
+      THEN( "index lists only the hot instance" )
+      {
+        REQUIRE(get_machines_in_state(&Root_HSM[0], found, CAPACITY) == 1);
+        REQUIRE(found[0] == wake_machine(&store, 1));
+      }
+
+      THEN( "broadcast to store reaches both and index lists the rehydrated instance" )
+      {
+        REQUIRE(broadcast_to_store(&store, &Root_HSM[0], 1, found, CAPACITY) == 2);
+        REQUIRE(found[0]->Event == 1);
+        REQUIRE(found[1]->Event == 1);
+        REQUIRE_FALSE(is_hibernated(&store, 0));
+        REQUIRE(get_machines_in_state(&Root_HSM[0], found, CAPACITY) == 2);
+      }
+    }
+
+    store_destroy_machine(&store, 0);
+    store_destroy_machine(&store, 1);
+    REQUIRE(get_machines_in_state(&Root_HSM[0], found, CAPACITY) == 0);
+  }
+}
+
+}
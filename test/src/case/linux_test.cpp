@@ -0,0 +1,189 @@
+/**
+ * \file
+ * \brief Test of Linux runtime of dispatcher
+
+ * \author  Nandkishor Biradar
+ * \date  19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+#include <thread>
+#include <chrono>
+#include <poll.h>
+#include <signal.h>
+#include <errno.h>
+
+#include "catch.hpp"
+
+#include "hsm.h"
+#include "hsm_post.h"
+#include "hsm_linux.h"
+
+namespace linux_test
+{
+
+uint32_t Last_Event;
+uint32_t Total_Events;
+
+state_machine_result_t handler(state_machine_t * const pState_Machine)
+{
+  Last_Event = pState_Machine->Event;
+  Total_Events++;
+  return EVENT_HANDLED;
+}
+
+linux_runtime_t* Signal_Runtime;
+state_machine_t* Signal_Machine;
+
+void signalHandler(int)
+{
+  runtime_post_from_signal(Signal_Runtime, Signal_Machine, 4, 0);
+}
+
+//! Wait until the runtime descriptor is readable.
+bool wait_readable(int fd, int milliseconds)
+{
+  struct pollfd pollFd = {fd, POLLIN, 0};
+  return poll(&pollFd, 1, milliseconds) == 1;
+}
+
+SCENARIO("Linux runtime")
+{
+  const static state_t testHSM[1] =
+  {
+    handler,
+    NULL,
+    NULL,
+    #if HIERARCHICAL_STATES
+    NULL,
+    NULL,
+    0
+    #endif
+  };
+
+  GIVEN( "A runtime with a state machine and a timer" )
+  {
+    state_machine_t machine = {};
+    state_machine_t * const machineList[] = {&machine};
+    machine.State = testHSM;
+    runtime_timer_t timers[2];
+    linux_runtime_t runtime;
+    Last_Event = 0;
+    Total_Events = 0;
+
+    const int fd = init_runtime(&runtime, machineList, 1, timers, 2);
+    REQUIRE(fd >= 0);
+    REQUIRE_FALSE(wait_readable(fd, 0));
+
+    WHEN( "event is posted from another thread" )
+    {
+      std::thread producer([&runtime, &machine]()
+      {
+        runtime_post(&runtime, &machine, 3, NULL);
+      });
+
+      THEN( "descriptor becomes readable and the event is dispatched" )
+      {
+        REQUIRE(wait_readable(fd, 1000));
+        producer.join();
+        REQUIRE(runtime_dispatch(&runtime) == EVENT_HANDLED);
+        REQUIRE(Last_Event == 3);
+        REQUIRE(machine.Event == 0);
+        REQUIRE_FALSE(wait_readable(fd, 0));
+      }
+
+      if(producer.joinable())
+      {
+        producer.join();
+      }
+    }
+
+    WHEN( "event is posted from signal handler" )
+    {
+      struct sigaction action = {}, previous;
+      action.sa_handler = signalHandler;
+      sigemptyset(&action.sa_mask);
+      Signal_Runtime = &runtime;
+      Signal_Machine = &machine;
+      REQUIRE(sigaction(SIGUSR1, &action, &previous) == 0);
+      errno = EINTR;
+      raise(SIGUSR1);
+
+      THEN( "descriptor becomes readable and errno is preserved" )
+      {
+        REQUIRE(errno == EINTR);
+        REQUIRE(wait_readable(fd, 1000));
+        REQUIRE(runtime_dispatch(&runtime) == EVENT_HANDLED);
+        REQUIRE(Last_Event == 4);
+      }
+
+      sigaction(SIGUSR1, &previous, NULL);
+    }
+
+    WHEN( "timers are started" )
+    {
+      start_timer(&runtime, 0, &machine, 5, 10);
+      start_timer(&runtime, 1, &machine, 6, 5000);
+
+      THEN( "earliest timer posts its event on expiry" )
+      {
+        REQUIRE_FALSE(wait_readable(fd, 0));
+        REQUIRE(wait_readable(fd, 1000));
+        REQUIRE(runtime_dispatch(&runtime) == EVENT_HANDLED);
+        REQUIRE(Last_Event == 5);
+        REQUIRE(Total_Events == 1);
+        REQUIRE(timers[0].Expiry == 0);
+        REQUIRE(timers[1].Expiry != 0);
+        REQUIRE_FALSE(wait_readable(fd, 0));
+      }
+    }
+
+    WHEN( "timer is stopped" )
+    {
+      start_timer(&runtime, 0, &machine, 5, 10);
+      stop_timer(&runtime, 0);
+
+      THEN( "it doesn't post the event" )
+      {
+        REQUIRE_FALSE(wait_readable(fd, 50));
+      }
+    }
+
+#if HSM_EVENT_QUEUE
+    WHEN( "timer expires while event queue with block policy is full" )
+    {
+      event_queue_t queue;
+      queued_event_t buffer[8 * HSM_QUEUE_LANES];
+      REQUIRE(init_event_queue(&machine, &queue, buffer, 8));
+      REQUIRE(set_overflow_policy(&queue, OVERFLOW_BLOCK, 5000));
+      for(uint32_t index = 0; index < 8; index++)
+      {
+        REQUIRE(post_event(&machine, 1, NULL));
+      }
+      start_timer(&runtime, 0, &machine, 1, 0);
+
+      THEN( "dispatcher doesn't block and posts the timer event once queue has room" )
+      {
+        const auto start = std::chrono::steady_clock::now();
+        while((Total_Events < 9) && wait_readable(fd, 1000))
+        {
+          runtime_dispatch(&runtime);
+        }
+        REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(1000));
+        REQUIRE(Total_Events == 9);
+        REQUIRE(timers[0].Expiry == 0);
+        REQUIRE(queue.Overflows == 1);
+      }
+    }
+#endif // HSM_EVENT_QUEUE
+
+    close_runtime(&runtime);
+  }
+}
+
+}
@@ -0,0 +1,271 @@
+/**
+ * \file
+ * \brief Test of pool of state machine instances
+
+ * \author  Nandkishor Biradar
+ * \date  19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+#include "catch.hpp"
+
+#include "hsm.h"
+#include "hsm_post.h"
+#include "hsm_pool.h"
+
+namespace pool_test
+{
+
+//! User derived state machine
+struct counter_t
+{
+  state_machine_t Machine;
+  uint32_t Count;
+};
+
+state_machine_result_t handler(state_machine_t * const pState_Machine)
+{
+  reinterpret_cast<counter_t*>(pState_Machine)->Count++;
+  return EVENT_HANDLED;
+}
+
+//! Destroy of instance requested from the post in progress
+std::atomic<bool> Destroy_Requested(false);
+std::atomic<bool> Destroyed(false);
+bool Destroyed_During_Post;
+
+void hold_post(event_queue_t* const, bool asserted)
+{
+  if(asserted)
+  {
+    Destroy_Requested.store(true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    Destroyed_During_Post = Destroyed.load();
+  }
+}
+
+const uint32_t CAPACITY = 8;
+alignas(HSM_POOL_CACHE_LINE) uint8_t Memory[MACHINE_POOL_SIZE(sizeof(counter_t), CAPACITY)];
+
+SCENARIO("Pool of state machine instances")
+{
+  const static state_t testHSM[1] =
+  {
+    handler,
+    NULL,
+    NULL,
+    #if HIERARCHICAL_STATES
+    NULL,
+    NULL,
+    0
+    #endif
+  };
+
+  GIVEN( "A pool of 8 instances" )
+  {
+    machine_pool_t pool;
+    REQUIRE_FALSE(init_machine_pool(&pool, &Memory[1], sizeof(counter_t), CAPACITY));
+    REQUIRE(init_machine_pool(&pool, Memory, sizeof(counter_t), CAPACITY));
+    REQUIRE(pool.Slot_Size == HSM_POOL_CACHE_LINE);
+
+    WHEN( "instances are created in bulk" )
+    {
+      state_machine_t* machines[CAPACITY + 1];
+      memset(Memory, 0xFF, sizeof(Memory));
+      const uint32_t created = create_machines(&pool, machines, CAPACITY + 1, testHSM);
+
+      THEN( "instances are cleared, cache line aligned and ready to dispatch" )
+      {
+        REQUIRE(created == CAPACITY);
+        REQUIRE(pool.Used == CAPACITY);
+        REQUIRE(create_machine(&pool, testHSM) == NULL);
+        for(uint32_t index = 0; index < CAPACITY; index++)
+        {
+          REQUIRE((reinterpret_cast<uintptr_t>(machines[index]) % HSM_POOL_CACHE_LINE) == 0);
+          REQUIRE(get_pool_index(&pool, machines[index]) == index);
+          REQUIRE(get_pool_machine(&pool, index) == machines[index]);
+          REQUIRE(machines[index]->Event == 0);
+          REQUIRE(reinterpret_cast<counter_t*>(machines[index])->Count == 0);
+        }
+
+        machines[3]->Event = 1;
+        REQUIRE(dispatch_event(machines, CAPACITY) == EVENT_HANDLED);
+        REQUIRE(reinterpret_cast<counter_t*>(machines[3])->Count == 1);
+      }
+
+      THEN( "destroyed slots are reused" )
+      {
+        destroy_machine(&pool, machines[2]);
+        destroy_machines(&pool, &machines[5], 2);
+        REQUIRE(pool.Used == CAPACITY - 3);
+
+        state_machine_t* reused[4];
+        REQUIRE(create_machines(&pool, reused, 4, testHSM) == 3);
+        REQUIRE(reused[0] == machines[6]);
+        REQUIRE(reused[1] == machines[5]);
+        REQUIRE(reused[2] == machines[2]);
+        REQUIRE(reused[0]->Event == 0);
+        REQUIRE(pool.Used == CAPACITY);
+      }
+
+      THEN( "reset destroys all the instances" )
+      {
+        reset_machine_pool(&pool);
+        REQUIRE(pool.Used == 0);
+        REQUIRE(create_machine(&pool, testHSM) == machines[0]);
+      }
+    }
+  }
+
+  GIVEN( "A pool of 8 instances with handles" )
+  {
+    machine_pool_t pool;
+    machine_slot_t slots[CAPACITY];
+    REQUIRE(init_machine_pool(&pool, Memory, sizeof(counter_t), CAPACITY));
+    REQUIRE(enable_machine_handles(&pool, slots));
+
+    state_machine_t* const machine = create_machine(&pool, testHSM);
+    const machine_handle_t handle = get_machine_handle(&pool, machine);
+
+    WHEN( "instance is alive" )
+    {
+      THEN( "handle resolves to the instance and events can be posted to it" )
+      {
+        REQUIRE(resolve_machine(&pool, handle) == machine);
+        REQUIRE(resolve_machine(&pool, INVALID_HANDLE) == NULL);
+        REQUIRE(post_event_to_handle(&pool, handle, 1, NULL));
+        REQUIRE(machine->Event == 1);
+      }
+    }
+
+    WHEN( "instance is destroyed and its slot is reused" )
+    {
+      destroy_machine(&pool, machine);
+      REQUIRE(resolve_machine(&pool, handle) == NULL);
+      state_machine_t* const reused = create_machine(&pool, testHSM);
+
+      THEN( "old handle is detected as stale" )
+      {
+        REQUIRE(reused == machine);
+        REQUIRE(resolve_machine(&pool, handle) == NULL);
+        REQUIRE_FALSE(post_event_to_handle(&pool, handle, 1, NULL));
+        REQUIRE(reused->Event == 0);
+
+        const machine_handle_t newHandle = get_machine_handle(&pool, reused);
+        REQUIRE(newHandle != handle);
+        REQUIRE(resolve_machine(&pool, newHandle) == reused);
+      }
+    }
+
+    WHEN( "pool is reset" )
+    {
+      reset_machine_pool(&pool);
+
+      THEN( "handles of all instances are invalid" )
+      {
+        REQUIRE(resolve_machine(&pool, handle) == NULL);
+      }
+    }
+  }
+
+  GIVEN( "An instance destroyed by other thread while an event is posted to its handle" )
+  {
+    machine_pool_t pool;
+    machine_slot_t slots[CAPACITY];
+    event_queue_t queue;
+    queued_event_t buffer[4 * HSM_QUEUE_LANES];
+    REQUIRE(init_machine_pool(&pool, Memory, sizeof(counter_t), CAPACITY));
+    REQUIRE(enable_machine_handles(&pool, slots));
+
+    state_machine_t* const machine = create_machine(&pool, testHSM);
+    const machine_handle_t handle = get_machine_handle(&pool, machine);
+    REQUIRE(init_event_queue(machine, &queue, buffer, 4));
+    // Backpressure handler is called from the post, it holds the post in progress.
+    REQUIRE(set_backpressure(&queue, 1, 0, hold_post));
+    Destroy_Requested.store(false);
+    Destroyed.store(false);
+
+    std::thread destroyer([&]()
+    {
+      while(!Destroy_Requested.load())
+      {
+        std::this_thread::yield();
+      }
+      destroy_machine(&pool, machine);
+      Destroyed.store(true);
+    });
+
+    const bool posted = post_event_to_handle(&pool, handle, 1, NULL);
+    destroyer.join();
+
+    THEN( "destroy waits for the post to complete and the handle is invalid afterwards" )
+    {
+      REQUIRE(posted);
+      REQUIRE_FALSE(Destroyed_During_Post);
+      REQUIRE(resolve_machine(&pool, handle) == NULL);
+      REQUIRE_FALSE(post_event_to_handle(&pool, handle, 1, NULL));
+      REQUIRE(create_machine(&pool, testHSM) == machine);
+      REQUIRE(pool.Free == POOL_END);
+    }
+  }
+
+  GIVEN( "An instance destroyed and created again while other thread posts to its handle" )
+  {
+    machine_pool_t pool;
+    machine_slot_t slots[CAPACITY];
+    REQUIRE(init_machine_pool(&pool, Memory, sizeof(counter_t), CAPACITY));
+    REQUIRE(enable_machine_handles(&pool, slots));
+
+    state_machine_t* machine = create_machine(&pool, testHSM);
+    std::atomic<machine_handle_t> current(get_machine_handle(&pool, machine));
+    std::atomic<bool> stop(false);
+    uint32_t stalePosts = 0;
+    uint32_t corrupted = 0;
+
+    std::thread poster([&]()
+    {
+      while(!stop.load())
+      {
+        post_event_to_handle(&pool, current.load(), 1, NULL);
+        std::this_thread::yield();
+      }
+    });
+
+    for(uint32_t cycle = 0; cycle < 20000; cycle++)
+    {
+      current.store(get_machine_handle(&pool, machine));
+      destroy_machine(&pool, machine);
+
+      // Destroyed slot is reused first, no event of the old handle may reach the new instance.
+      machine = create_machine(&pool, testHSM);
+      for(uint32_t count = 0; count < 16; count++)
+      {
+        stalePosts += (machine->Event != 0);
+      }
+      corrupted += (pool.Free != POOL_END);
+    }
+    stop.store(true);
+    poster.join();
+
+    THEN( "free list is intact and the new instance gets no stale event" )
+    {
+      REQUIRE(stalePosts == 0);
+      REQUIRE(corrupted == 0);
+      state_machine_t* machines[CAPACITY];
+      REQUIRE(create_machines(&pool, machines, CAPACITY, testHSM) == CAPACITY - 1);
+    }
+  }
+}
+
+}
@@ -0,0 +1,512 @@
+/**
+ * \file
+ * \brief Test of event posting with completion token
+
+ * \author  Nandkishor Biradar
+ * \date  19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+#include <thread>
+
+#include "catch.hpp"
+#define _HIPPOMOCKS__ENABLE_CFUNC_MOCKING_SUPPORT
+#include "hippomocks.h"
+
+#include "hsm.h"
+#include "hsm_post.h"
+
+namespace post_test
+{
+
+state_machine_result_t handler(state_machine_t * const)
+{
+  return EVENT_HANDLED;
+}
+
+state_machine_result_t selfTrigger(state_machine_t * const pState_Machine)
+{
+  pState_Machine->Event = 2;
+  return TRIGGERED_TO_SELF;
+}
+
+SCENARIO("Post event with completion token")
+{
+  const static state_t testHSM[1] =
+  {
+    handler,
+    NULL,
+    NULL,
+    #if HIERARCHICAL_STATES
+    NULL,
+    NULL,
+    0
+    #endif
+  };
+
+  GIVEN( "A state machine without pending event" )
+  {
+    state_machine_t machine = {};
+    state_machine_t * const machineList[] = {&machine};
+    machine.State = testHSM;
+    event_token_t token;
+
+    WHEN( "event is posted" )
+    {
+      REQUIRE(post_event(&machine, 1, &token));
+
+      THEN( "Another event can't be posted until it is processed" )
+      {
+        REQUIRE(machine.Event == 1);
+        REQUIRE_FALSE(is_event_completed(&token));
+        REQUIRE_FALSE(post_event(&machine, 2, NULL));
+
+        MockRepository mocks;
+        mocks.ExpectCallFunc(handler).With(&machine).Return(EVENT_HANDLED);
+
+        REQUIRE(dispatch_event(machineList, 1) == EVENT_HANDLED);
+        REQUIRE(is_event_completed(&token));
+        REQUIRE(wait_event(&token) == EVENT_HANDLED);
+        REQUIRE(post_event(&machine, 2, NULL));
+      }
+    }
+
+    WHEN( "event with completed token is rejected" )
+    {
+      REQUIRE(post_event(&machine, 1, &token));
+      MockRepository mocks;
+      mocks.ExpectCallFunc(handler).With(&machine).Return(EVENT_HANDLED);
+      REQUIRE(dispatch_event(machineList, 1) == EVENT_HANDLED);
+      REQUIRE(post_event(&machine, 1, NULL));
+
+      THEN( "the token is not modified" )
+      {
+        REQUIRE_FALSE(post_event(&machine, 2, &token));
+        REQUIRE(is_event_completed(&token));
+      }
+    }
+
+    WHEN( "Handler triggers event to self" )
+    {
+      REQUIRE(post_event(&machine, 1, &token));
+
+      MockRepository mocks;
+      mocks.ExpectCallFunc(handler).With(&machine).Do(selfTrigger);
+      mocks.ExpectCallFunc(handler).With(&machine).Return(EVENT_HANDLED);
+
+      THEN( "Token is resolved after first run to completion step" )
+      {
+        REQUIRE(dispatch_event(machineList, 1) == EVENT_HANDLED);
+        REQUIRE(wait_event(&token) == TRIGGERED_TO_SELF);
+        REQUIRE(machine.Token == NULL);
+      }
+    }
+
+    WHEN( "Handler couldn't handle the posted event" )
+    {
+      REQUIRE(post_event(&machine, 1, &token));
+
+      MockRepository mocks;
+      mocks.ExpectCallFunc(handler).With(&machine).Return(EVENT_UN_HANDLED);
+
+      THEN( "Token is resolved with error and event stays pending" )
+      {
+        REQUIRE(dispatch_event(machineList, 1) == EVENT_UN_HANDLED);
+        REQUIRE(wait_event(&token) == EVENT_UN_HANDLED);
+        REQUIRE_FALSE(post_event(&machine, 2, NULL));
+      }
+    }
+
+    WHEN( "Producer thread waits for the posted event" )
+    {
+      state_machine_result_t result = EVENT_UN_HANDLED;
+      std::thread producer([&machine, &token, &result]()
+      {
+        while(!post_event(&machine, 1, &token));
+        result = wait_event(&token);
+      });
+
+      THEN( "Producer wakes up after the event is dispatched" )
+      {
+        while(HSM_LOAD_ACQUIRE(&machine.Event) == 0)
+        {
+          std::this_thread::yield();
+        }
+        REQUIRE(dispatch_event(machineList, 1) == EVENT_HANDLED);
+        producer.join();
+        REQUIRE(result == EVENT_HANDLED);
+      }
+
+      if(producer.joinable())
+      {
+        producer.join();
+      }
+    }
+  }
+}
+
+#if HSM_EVENT_QUEUE
+uint32_t Events[64];
+uint32_t Payloads[64];
+uint32_t Total_Events;
+
+state_machine_result_t queueHandler(state_machine_t * const pState_Machine)
+{
+  Events[Total_Events % 64] = pState_Machine->Event;
+  Payloads[Total_Events % 64] = get_event_payload(pState_Machine);
+  Total_Events++;
+  return EVENT_HANDLED;
+}
+
+uint32_t Backpressure_Changes;
+bool Backpressure_Asserted;
+
+void backpressureHandler(event_queue_t * const, bool asserted)
+{
+  Backpressure_Asserted = asserted;
+  Backpressure_Changes++;
+}
+
+SCENARIO("Event queue")
+{
+  const static state_t testHSM[1] =
+  {
+    queueHandler,
+    NULL,
+    NULL,
+    #if HIERARCHICAL_STATES
+    NULL,
+    NULL,
+    0
+    #endif
+  };
+
+  GIVEN( "A state machine with event queue of 8 events" )
+  {
+    state_machine_t machine = {};
+    state_machine_t * const machineList[] = {&machine};
+    machine.State = testHSM;
+    event_queue_t queue;
+    queued_event_t buffer[8 * HSM_QUEUE_LANES];
+    Total_Events = 0;
+
+    REQUIRE_FALSE(init_event_queue(&machine, &queue, buffer, 6));
+    REQUIRE(init_event_queue(&machine, &queue, buffer, 8));
+
+    WHEN( "events are posted" )
+    {
+      REQUIRE(post_event_payload(&machine, 3, 30, NULL));
+      REQUIRE(post_event(&machine, 1, NULL));
+      REQUIRE(post_event_payload(&machine, 2, 20, NULL));
+
+      THEN( "they are dispatched in order with their payload" )
+      {
+        REQUIRE(machine.Event == 0);
+        REQUIRE(dispatch_event(machineList, 1) == EVENT_HANDLED);
+        REQUIRE(Total_Events == 3);
+        REQUIRE(Events[0] == 3);
+        REQUIRE(Payloads[0] == 30);
+        REQUIRE(Events[1] == 1);
+        REQUIRE(Events[2] == 2);
+        REQUIRE(Payloads[2] == 20);
+        REQUIRE(machine.Event == 0);
+      }
+    }
+
+    WHEN( "queue is full" )
+    {
+      for(uint32_t index = 0; index < 8; index++)
+      {
+        REQUIRE(post_event(&machine, 1, NULL));
+      }
+
+      THEN( "posting fails until the dispatcher fetches an event" )
+      {
+        REQUIRE_FALSE(post_event(&machine, 2, NULL));
+#if HSM_EVENT_COMPLETION
+        event_token_t token;
+        token.Status = 1;   // Completed
+        REQUIRE_FALSE(post_event(&machine, 2, &token));
+        REQUIRE(is_event_completed(&token));
+#endif // HSM_EVENT_COMPLETION
+        REQUIRE(dispatch_event(machineList, 1) == EVENT_HANDLED);
+        REQUIRE(Total_Events == 8);
+        REQUIRE(post_event(&machine, 2, NULL));
+      }
+    }
+
+    WHEN( "duplicate events with drop duplicate rule are posted" )
+    {
+      REQUIRE(set_coalescing(&queue, 5, COALESCE_DROP_DUPLICATE));
+      REQUIRE(post_event_payload(&machine, 5, 1, NULL));
+      REQUIRE(post_event(&machine, 2, NULL));
+      REQUIRE(post_event_payload(&machine, 5, 2, NULL));
+      REQUIRE(post_event_payload(&machine, 5, 3, NULL));
+
+      THEN( "only first event is dispatched" )
+      {
+        REQUIRE(get_merged_events(&queue) == 2);
+        REQUIRE(dispatch_event(machineList, 1) == EVENT_HANDLED);
+        REQUIRE(Total_Events == 2);
+        REQUIRE(Events[0] == 5);
+        REQUIRE(Payloads[0] == 1);
+        REQUIRE(Events[1] == 2);
+      }
+    }
+
+    WHEN( "duplicate events with keep latest rule are posted" )
+    {
+      REQUIRE(set_coalescing(&queue, 6, COALESCE_KEEP_LATEST));
+      REQUIRE(post_event_payload(&machine, 6, 1, NULL));
+      REQUIRE(post_event_payload(&machine, 6, 2, NULL));
+      REQUIRE(post_event_payload(&machine, 6, 3, NULL));
+
+      THEN( "event is dispatched once with latest payload" )
+      {
+        REQUIRE(get_merged_events(&queue) == 2);
+        REQUIRE(dispatch_event(machineList, 1) == EVENT_HANDLED);
+        REQUIRE(Total_Events == 1);
+        REQUIRE(Events[0] == 6);
+        REQUIRE(Payloads[0] == 3);
+
+        // Event posted after dispatch is queued again.
+        REQUIRE(post_event_payload(&machine, 6, 4, NULL));
+        REQUIRE(dispatch_event(machineList, 1) == EVENT_HANDLED);
+        REQUIRE(Total_Events == 2);
+        REQUIRE(Payloads[1] == 4);
+      }
+    }
+
+    WHEN( "event is posted with completion token" )
+    {
+      event_token_t token;
+      REQUIRE(post_event(&machine, 1, NULL));
+      REQUIRE(post_event(&machine, 2, &token));
+
+      THEN( "token is resolved when its event is dispatched" )
+      {
+        REQUIRE(dispatch_event(machineList, 1) == EVENT_HANDLED);
+        REQUIRE(wait_event(&token) == EVENT_HANDLED);
+        REQUIRE(Total_Events == 2);
+      }
+    }
+
+    WHEN( "queue with drop oldest policy is full" )
+    {
+      event_token_t token;
+      REQUIRE(set_overflow_policy(&queue, OVERFLOW_DROP_OLDEST, 0));
+      REQUIRE(post_event_payload(&machine, 1, 0, &token));
+      for(uint32_t index = 1; index < 8; index++)
+      {
+        REQUIRE(post_event_payload(&machine, 1, index, NULL));
+      }
+      REQUIRE(post_event_payload(&machine, 2, 8, NULL));
+
+      THEN( "oldest event is dropped and its token is resolved" )
+      {
+        REQUIRE(get_dropped_events(&queue) == 1);
+        REQUIRE(queue.Overflows == 1);
+        REQUIRE(is_event_completed(&token));
+        REQUIRE(wait_event(&token) == EVENT_UN_HANDLED);
+        REQUIRE(dispatch_event(machineList, 1) == EVENT_HANDLED);
+        REQUIRE(Total_Events == 8);
+        REQUIRE(Payloads[0] == 1);
+        REQUIRE(Events[7] == 2);
+        REQUIRE(Payloads[7] == 8);
+      }
+    }
+
+    WHEN( "event is posted from interrupt to full queue" )
+    {
+      REQUIRE(set_overflow_policy(&queue, OVERFLOW_DROP_OLDEST, 0));
+      REQUIRE(post_event_from_isr(&machine, 3, 30));
+      for(uint32_t index = 1; index < 8; index++)
+      {
+        REQUIRE(post_event(&machine, 1, NULL));
+      }
+
+      THEN( "it is rejected without applying the overflow policy" )
+      {
+        REQUIRE_FALSE(post_event_from_isr(&machine, 2, 0));
+        REQUIRE(get_dropped_events(&queue) == 0);
+        REQUIRE(dispatch_event(machineList, 1) == EVENT_HANDLED);
+        REQUIRE(Total_Events == 8);
+        REQUIRE(Events[0] == 3);
+        REQUIRE(Payloads[0] == 30);
+      }
+    }
+
+#if defined(__linux__)
+    WHEN( "queue with block policy is full" )
+    {
+      REQUIRE(set_overflow_policy(&queue, OVERFLOW_BLOCK, 20));
+      for(uint32_t index = 0; index < 8; index++)
+      {
+        REQUIRE(post_event(&machine, 1, NULL));
+      }
+
+      THEN( "producer is blocked until the dispatcher fetches an event or timeout expires" )
+      {
+        REQUIRE_FALSE(post_event(&machine, 2, NULL));
+
+        REQUIRE(set_overflow_policy(&queue, OVERFLOW_BLOCK, 5000));
+        bool posted = false;
+        std::thread producer([&machine, &posted]()
+        {
+          posted = post_event(&machine, 2, NULL);
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        REQUIRE(dispatch_event(machineList, 1) == EVENT_HANDLED);
+        producer.join();
+        REQUIRE(posted);
+        REQUIRE(queue.Overflows == 2);
+        REQUIRE(dispatch_event(machineList, 1) == EVENT_HANDLED);
+        REQUIRE(Events[(Total_Events - 1) % 64] == 2);
+      }
+    }
+
+    WHEN( "coalesced event is posted while its first post is blocked on full queue" )
+    {
+      REQUIRE(set_coalescing(&queue, 5, COALESCE_DROP_DUPLICATE));
+      REQUIRE(set_overflow_policy(&queue, OVERFLOW_BLOCK, 100));
+      for(uint32_t index = 0; index < 8; index++)
+      {
+        REQUIRE(post_event(&machine, 1, NULL));
+      }
+
+      bool first = true;
+      std::thread producer([&machine, &first]()
+      {
+        first = post_event(&machine, 5, NULL);
+      });
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      const bool second = post_event(&machine, 5, NULL);
+      producer.join();
+
+      THEN( "second post is not merged with the rejected first post" )
+      {
+        REQUIRE_FALSE(first);
+        REQUIRE_FALSE(second);
+        REQUIRE(get_merged_events(&queue) == 0);
+        REQUIRE(dispatch_event(machineList, 1) == EVENT_HANDLED);
+        REQUIRE(Total_Events == 8);
+
+        // Event is coalesced again once it is queued.
+        REQUIRE(post_event(&machine, 5, NULL));
+        REQUIRE(post_event(&machine, 5, NULL));
+        REQUIRE(get_merged_events(&queue) == 1);
+      }
+    }
+#endif // defined(__linux__)
+
+    WHEN( "queue depth reaches the backpressure threshold" )
+    {
+      Backpressure_Changes = 0;
+      REQUIRE_FALSE(set_backpressure(&queue, 2, 2, backpressureHandler));
+      REQUIRE(set_backpressure(&queue, 4, 1, backpressureHandler));
+      for(uint32_t index = 0; index < 3; index++)
+      {
+        REQUIRE(post_event(&machine, 1, NULL));
+      }
+      REQUIRE_FALSE(is_backpressured(&queue));
+      REQUIRE(post_event(&machine, 1, NULL));
+
+      THEN( "backpressure is asserted until the queue drains to the low threshold" )
+      {
+        REQUIRE(is_backpressured(&queue));
+        REQUIRE(Backpressure_Changes == 1);
+        REQUIRE(Backpressure_Asserted);
+        REQUIRE(get_high_water_mark(&queue) == 4);
+        REQUIRE(dispatch_event(machineList, 1) == EVENT_HANDLED);
+        REQUIRE_FALSE(is_backpressured(&queue));
+        REQUIRE(Backpressure_Changes == 2);
+        REQUIRE_FALSE(Backpressure_Asserted);
+        REQUIRE(get_high_water_mark(&queue) == 4);
+      }
+    }
+
+#if HSM_QUEUE_LANES > 1
+    WHEN( "urgent event is posted after periodic events" )
+    {
+      REQUIRE(set_event_lane(&queue, 7, 0));
+      REQUIRE(set_event_lane(&queue, 8, 1));
+      REQUIRE_FALSE(set_event_lane(&queue, 8, HSM_QUEUE_LANES));
+      REQUIRE(post_event(&machine, 1, NULL));
+      REQUIRE(post_event(&machine, 1, NULL));
+      REQUIRE(post_event(&machine, 8, NULL));
+      REQUIRE(post_event(&machine, 7, NULL));
+
+      THEN( "it overtakes the events of lower priority lanes" )
+      {
+        REQUIRE(dispatch_event(machineList, 1) == EVENT_HANDLED);
+        REQUIRE(Total_Events == 4);
+        REQUIRE(Events[0] == 7);
+        REQUIRE(Events[1] == 8);
+        REQUIRE(Events[2] == 1);
+        REQUIRE(Events[3] == 1);
+        REQUIRE(queue.Nonempty == 0);
+      }
+    }
+
+    WHEN( "lane is full" )
+    {
+      REQUIRE(set_event_lane(&queue, 7, 0));
+      for(uint32_t index = 0; index < 8; index++)
+      {
+        REQUIRE(post_event(&machine, 1, NULL));
+      }
+
+      THEN( "events can be posted in other lanes" )
+      {
+        REQUIRE_FALSE(post_event(&machine, 1, NULL));
+        REQUIRE(post_event(&machine, 7, NULL));
+      }
+    }
+#endif // HSM_QUEUE_LANES > 1
+
+    WHEN( "events are posted from multiple threads" )
+    {
+      const uint32_t PRODUCERS = 4;
+      const uint32_t EVENTS_PER_PRODUCER = 10000;
+      std::thread producers[PRODUCERS];
+      for(uint32_t producer = 0; producer < PRODUCERS; producer++)
+      {
+        producers[producer] = std::thread([&machine, producer]()
+        {
+          for(uint32_t count = 0; count < EVENTS_PER_PRODUCER; count++)
+          {
+            while(!post_event_payload(&machine, 1, producer, NULL))
+            {
+              std::this_thread::yield();
+            }
+          }
+        });
+      }
+
+      THEN( "all the events are dispatched" )
+      {
+        state_machine_result_t result = EVENT_HANDLED;
+        while((Total_Events < (PRODUCERS * EVENTS_PER_PRODUCER)) && (result != EVENT_UN_HANDLED))
+        {
+          result = dispatch_event(machineList, 1);
+          std::this_thread::yield();
+        }
+        REQUIRE(result != EVENT_UN_HANDLED);
+        REQUIRE(Total_Events == (PRODUCERS * EVENTS_PER_PRODUCER));
+      }
+
+      for(uint32_t producer = 0; producer < PRODUCERS; producer++)
+      {
+        producers[producer].join();
+      }
+    }
+  }
+}
+#endif // HSM_EVENT_QUEUE
+
+}
@@ -17,6 +17,7 @@
 #include "hippomocks.h"
 
 #include "hsm.h"
+#include "hsm_post.h"
 
 namespace priority_test
 {
@@ -158,4 +159,118 @@ SCENARIO("Priority test ")
   }
 }
 
+SCENARIO("Grouped dispatch ")
+{
+  const static state_t testHSM[] =
+  {
+    handler1,
+    NULL,
+    NULL,
+    #if HIERARCHICAL_STATES
+    NULL,
+    NULL,
+    0
+    #endif
+  };
+
+  const static state_t test1HSM[] =
+  {
+    handler2,
+    NULL,
+    NULL,
+    #if HIERARCHICAL_STATES
+    NULL,
+    NULL,
+    0
+    #endif
+  };
+
+  GIVEN( "Three state machines, first and last are in the same state" )
+  {
+    machine1.State = &testHSM[0];
+    machine2.State = &test1HSM[0];
+    machine3.State = &testHSM[0];
+
+    state_machine_t * const machineList[] = {&machine1, &machine2, &machine3};
+
+    WHEN( "All state machines are triggered with same event" )
+    {
+      machine1.Event = 1;
+      machine2.Event = 1;
+      machine3.Event = 1;
+
+      MockRepository mocks;
+      mocks.ExpectCallFunc(handler1).With(&machine1).Return(EVENT_HANDLED);
+      mocks.ExpectCallFunc(handler1).With(&machine3).Return(EVENT_HANDLED);
+      mocks.ExpectCallFunc(handler2).With(&machine2).Return(EVENT_HANDLED);
+
+      THEN( "It invokes handler of a state for all its state machines back to back" )
+      {
+        REQUIRE(dispatch_event_grouped(machineList, sizeof(machineList)/sizeof(machineList[0])) == EVENT_HANDLED);
+        REQUIRE(machine1.Event == 0);
+        REQUIRE(machine2.Event == 0);
+        REQUIRE(machine3.Event == 0);
+      }
+    }
+
+    WHEN( "State machines in the same state have different events" )
+    {
+      machine1.Event = 1;
+      machine2.Event = 1;
+      machine3.Event = 2;
+
+      MockRepository mocks;
+      mocks.ExpectCallFunc(handler1).With(&machine1).Return(EVENT_HANDLED);
+      mocks.ExpectCallFunc(handler2).With(&machine2).Return(EVENT_HANDLED);
+      mocks.ExpectCallFunc(handler1).With(&machine3).Do(selfTrigger);
+      mocks.ExpectCallFunc(handler2).With(&machine2).Return(EVENT_HANDLED);
+      mocks.ExpectCallFunc(handler1).With(&machine3).Return(EVENT_HANDLED);
+
+      THEN( "It dispatches events triggered by handlers in the next pass" )
+      {
+        REQUIRE(dispatch_event_grouped(machineList, sizeof(machineList)/sizeof(machineList[0])) == EVENT_HANDLED);
+        REQUIRE(machine1.Event == 0);
+        REQUIRE(machine2.Event == 0);
+        REQUIRE(machine3.Event == 0);
+      }
+    }
+  }
+
+#if HSM_EVENT_QUEUE
+  GIVEN( "Three state machines, next event of the last one is in its queue" )
+  {
+    event_queue_t queue;
+    queued_event_t buffer[4 * HSM_QUEUE_LANES];
+    machine1.State = &testHSM[0];
+    machine2.State = &test1HSM[0];
+    machine3.State = &testHSM[0];
+    REQUIRE(init_event_queue(&machine3, &queue, buffer, 4));
+
+    state_machine_t * const machineList[] = {&machine1, &machine2, &machine3};
+
+    WHEN( "State machines in the same state have the same event" )
+    {
+      machine1.Event = 1;
+      machine2.Event = 1;
+      REQUIRE(post_event(&machine3, 1, NULL));
+
+      MockRepository mocks;
+      mocks.ExpectCallFunc(handler1).With(&machine1).Return(EVENT_HANDLED);
+      mocks.ExpectCallFunc(handler1).With(&machine3).Return(EVENT_HANDLED);
+      mocks.ExpectCallFunc(handler2).With(&machine2).Return(EVENT_HANDLED);
+
+      THEN( "It fetches the queued event and dispatches it with its group" )
+      {
+        REQUIRE(dispatch_event_grouped(machineList, sizeof(machineList)/sizeof(machineList[0])) == EVENT_HANDLED);
+        REQUIRE(machine1.Event == 0);
+        REQUIRE(machine2.Event == 0);
+        REQUIRE(machine3.Event == 0);
+      }
+    }
+
+    machine3.Queue = NULL;
+  }
+#endif // HSM_EVENT_QUEUE
+}
+
 }
@@ -0,0 +1,296 @@
+/**
+ * \file
+ * \brief Record and replay test
+
+ * \author  Nandkishor Biradar
+ * \date  19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+#include "catch.hpp"
+
+#include <stdint.h>
+#include "hsm.h"
+#include "hsm_post.h"
+#include "hsm_record.h"
+
+namespace record_test
+{
+
+extern const state_t Switch_State[2];
+
+uint32_t Ticks;
+
+uint32_t clock(void)
+{
+  return Ticks;
+}
+
+uint32_t Waits;
+
+void wait(uint32_t deadline)
+{
+  Waits++;
+  if((int32_t)(deadline - Ticks) > 0)
+  {
+    Ticks = deadline;
+  }
+}
+
+//! Ticks taken by each dispatch
+uint32_t Dispatch_Ticks;
+
+state_machine_result_t off_handler(state_machine_t * const pMachine)
+{
+  Ticks += Dispatch_Ticks;
+  return switch_state(pMachine, &Switch_State[1]);
+}
+
+state_machine_result_t on_handler(state_machine_t * const pMachine)
+{
+  Ticks += Dispatch_Ticks;
+  return switch_state(pMachine, &Switch_State[0]);
+}
+
+const state_t Switch_State[2] =
+{
+  {
+    off_handler,
+    NULL,
+    NULL,
+    #if HIERARCHICAL_STATES
+    NULL,
+    NULL,
+    0
+    #endif
+  },
+  {
+    on_handler,
+    NULL,
+    NULL,
+    #if HIERARCHICAL_STATES
+    NULL,
+    NULL,
+    0
+    #endif
+  }
+};
+
+const state_t* const State_Table[] = {&Switch_State[0], &Switch_State[1]};
+
+SCENARIO("Record and replay events")
+{
+  GIVEN("Recording of events posted to two state machines")
+  {
+    state_machine_t machine1 = {}, machine2 = {};
+    state_machine_t * const machineList[] = {&machine1, &machine2};
+    machine1.State = &Switch_State[0];
+    machine2.State = &Switch_State[0];
+    machine1.Event = 0;
+    machine2.Event = 0;
+
+    event_record_t log[8];
+    event_recorder_t recorder;
+    init_recorder(&recorder, log, 8, clock, State_Table, 2);
+    Dispatch_Ticks = 0;
+
+    Ticks = 10;
+    REQUIRE(record_event(&recorder, 0, 1));
+    machine1.Event = 1;
+    dispatch_event(machineList, 2);
+
+    Ticks = 15;
+    REQUIRE(record_event(&recorder, 1, 1));
+    machine2.Event = 1;
+    dispatch_event(machineList, 2);
+
+    Ticks = 30;
+    REQUIRE(record_event(&recorder, 1, 1));
+    machine2.Event = 1;
+    dispatch_event(machineList, 2);
+
+    REQUIRE(record_states(&recorder, machineList, 2));
+    REQUIRE(recorder.Count == 5);
+    REQUIRE(log[3].Machine == RECORD_STATE_CHECKPOINT);
+    REQUIRE(log[3].Value == 1);
+    REQUIRE(log[4].Value == 0);
+
+    machine1.State = &Switch_State[0];
+    machine2.State = &Switch_State[0];
+    replay_report_t report;
+
+    WHEN("Log is replayed as fast as possible")
+    {
+      Waits = 0;
+      REQUIRE(replay_events(&recorder, machineList, 2, NULL, &report) == EVENT_HANDLED);
+
+      THEN("replayed states are same as recorded states")
+      {
+        REQUIRE(report.Events == 3);
+        REQUIRE(report.Checkpoints == 2);
+        REQUIRE(report.Divergences == 0);
+        REQUIRE(Waits == 0);
+      }
+    }
+
+    WHEN("Log is replayed in real time")
+    {
+      Waits = 0;
+      Ticks = 100;
+      REQUIRE(replay_events(&recorder, machineList, 2, wait, &report) == EVENT_HANDLED);
+
+      THEN("replay waits until the recorded time of each event")
+      {
+        REQUIRE(report.Events == 3);
+        REQUIRE(Waits == 5);
+        REQUIRE(report.Elapsed == 20);
+      }
+    }
+
+    WHEN("Log is replayed in real time and each dispatch takes time")
+    {
+      Ticks = 100;
+      Dispatch_Ticks = 4;
+      REQUIRE(replay_events(&recorder, machineList, 2, wait, &report) == EVENT_HANDLED);
+
+      THEN("time taken by dispatch doesn't delay the following events")
+      {
+        // Events are replayed at 100, 105 and 120, the last dispatch ends at 124.
+        REQUIRE(report.Events == 3);
+        REQUIRE(report.Elapsed == 24);
+      }
+    }
+
+    WHEN("Replay starts from a different state")
+    {
+      machine2.State = &Switch_State[1];
+      REQUIRE(replay_events(&recorder, machineList, 2, NULL, &report) == EVENT_HANDLED);
+
+      THEN("replay reports the divergence")
+      {
+        REQUIRE(report.Checkpoints == 2);
+        REQUIRE(report.Divergences == 1);
+      }
+    }
+
+    WHEN("Log is full")
+    {
+      THEN("recorder rejects the new events")
+      {
+        REQUIRE(record_event(&recorder, 0, 1));
+        REQUIRE(record_event(&recorder, 0, 1));
+        REQUIRE(record_event(&recorder, 0, 1));
+        REQUIRE_FALSE(record_event(&recorder, 0, 1));
+        REQUIRE(recorder.Count == 8);
+      }
+    }
+  }
+
+#if HSM_EVENT_RECORDER
+  GIVEN("State machines attached to the recorder")
+  {
+    state_machine_t machine1 = {}, machine2 = {};
+    machine1.State = &Switch_State[0];
+    machine2.State = &Switch_State[0];
+
+    event_record_t log[4];
+    event_recorder_t recorder;
+    init_recorder(&recorder, log, 4, clock, State_Table, 2);
+    attach_recorder(&machine1, &recorder, 0);
+    attach_recorder(&machine2, &recorder, 1);
+
+    WHEN("events are posted to the state machines")
+    {
+      Ticks = 5;
+      REQUIRE(post_event(&machine2, 1, NULL));
+      Ticks = 7;
+      REQUIRE(post_event(&machine1, 2, NULL));
+      REQUIRE_FALSE(post_event(&machine1, 3, NULL));    // Rejected, pending event
+
+      THEN("only accepted events are recorded")
+      {
+        REQUIRE(recorder.Count == 2);
+        REQUIRE(log[0].Time == 5);
+        REQUIRE(log[0].Machine == 1);
+        REQUIRE(log[0].Value == 1);
+        REQUIRE(log[1].Time == 7);
+        REQUIRE(log[1].Machine == 0);
+        REQUIRE(log[1].Value == 2);
+      }
+    }
+
+    WHEN("recording is replayed to the state machines attached to it")
+    {
+      state_machine_t * const machineList[] = {&machine1, &machine2};
+      Ticks = 5;
+      REQUIRE(post_event(&machine2, 1, NULL));
+      REQUIRE(post_event(&machine1, 1, NULL));
+      REQUIRE(dispatch_event(machineList, 2) == EVENT_HANDLED);
+      machine1.State = &Switch_State[0];
+      machine2.State = &Switch_State[0];
+
+      replay_report_t report;
+      REQUIRE(replay_events(&recorder, machineList, 2, NULL, &report) == EVENT_HANDLED);
+
+      THEN("only the records present at the start are replayed and replayed events are recorded")
+      {
+        REQUIRE(report.Events == 2);
+        REQUIRE(report.Rejected == 0);
+        REQUIRE(recorder.Count == 4);
+        REQUIRE(log[2].Machine == 1);
+        REQUIRE(log[3].Machine == 0);
+        REQUIRE(machine1.State == &Switch_State[1]);
+        REQUIRE(machine2.State == &Switch_State[1]);
+      }
+    }
+
+    WHEN("recorder is detached")
+    {
+      attach_recorder(&machine1, NULL, 0);
+      REQUIRE(post_event(&machine1, 1, NULL));
+
+      THEN("events are not recorded")
+      {
+        REQUIRE(recorder.Count == 0);
+      }
+    }
+  }
+#endif // HSM_EVENT_RECORDER
+
+#if defined(__linux__)
+  GIVEN("Recording with monotonic clock")
+  {
+    state_machine_t machine = {};
+    state_machine_t * const machineList[] = {&machine};
+    machine.State = &Switch_State[0];
+
+    event_record_t log[2];
+    event_recorder_t recorder;
+    init_recorder(&recorder, log, 2, record_clock_monotonic, State_Table, 2);
+    Dispatch_Ticks = 0;
+    log[0] = {1000, 0, 1};
+    log[1] = {3000, 0, 1};
+    recorder.Count = 2;
+
+    WHEN("Log is replayed in real time")
+    {
+      replay_report_t report;
+      REQUIRE(replay_events(&recorder, machineList, 1, replay_wait_monotonic, &report) == EVENT_HANDLED);
+
+      THEN("replay sleeps until the recorded time")
+      {
+        REQUIRE(report.Events == 2);
+        REQUIRE(report.Elapsed >= 2000);
+        REQUIRE(machine.State == &Switch_State[0]);
+      }
+    }
+  }
+#endif // __linux__
+}
+
+}
@@ -25,6 +25,14 @@ state_machine_result_t handler(state_machine_t * const)
   return EVENT_HANDLED;
 }
 
+uint32_t Now;
+
+//! Clock of dispatch_event_bounded that advances on each read.
+uint32_t tick_clock()
+{
+  return Now++;
+}
+
 SCENARIO("Simple State machine handling event")
 {
   const state_t testHSM[1] =
@@ -41,7 +49,7 @@ SCENARIO("Simple State machine handling event")
 
   GIVEN( "A simple state machine" )
   {
-    state_machine_t machine;
+    state_machine_t machine = {};
     state_machine_t * const machineList[] = {&machine};
 
     WHEN( "event is triggered" )
@@ -63,6 +71,9 @@ SCENARIO("Simple State machine handling event")
       {
         REQUIRE(dispatch_event(machineList, 1) == EVENT_HANDLED);
         REQUIRE(machine.Event == 0);
+#if HSM_PUBLISH_STATE
+        REQUIRE(observe_state(&machine) == testHSM);
+#endif // HSM_PUBLISH_STATE
       }
     }
 
@@ -118,6 +129,100 @@ SCENARIO("Simple State machine handling event")
         REQUIRE(machine.Event == 0);
       }
     }
+
+#if HSM_DISPATCH_BUDGET
+    WHEN("Handler keeps triggering the event to self")
+    {
+      machine.State = &testHSM[0];
+      machine.Event = 1;
+
+      uint32_t invocations = 0;
+      MockRepository mocks;
+      mocks.OnCallFunc(handler).With(&machine).Do(
+        [&invocations](state_machine_t * const pMachine)
+        {
+          invocations++;
+          pMachine->Event = 2;
+          return TRIGGERED_TO_SELF;
+        });
+
+      THEN( "dispatcher returns after exhausting its budget and event is still pending" )
+      {
+        REQUIRE(dispatch_event(machineList, 1) == BUDGET_EXHAUSTED);
+        REQUIRE(invocations == HSM_DISPATCH_BUDGET);
+        REQUIRE(machine.Event == 2);
+      }
+    }
+#endif // HSM_DISPATCH_BUDGET
+
+    WHEN("Handler keeps triggering the event to self with the budget chosen by caller")
+    {
+      machine.State = &testHSM[0];
+      machine.Event = 1;
+
+      uint32_t invocations = 0;
+      MockRepository mocks;
+      mocks.OnCallFunc(handler).With(&machine).Do(
+        [&invocations](state_machine_t * const pMachine)
+        {
+          invocations++;
+          pMachine->Event = (invocations < 10) ? 2 : 0;
+          return (invocations < 10) ? TRIGGERED_TO_SELF : EVENT_HANDLED;
+        });
+
+      THEN( "dispatcher returns after exhausting the given budget" )
+      {
+        REQUIRE(dispatch_event_budget(machineList, 1, 3) == BUDGET_EXHAUSTED);
+        REQUIRE(invocations == 3);
+        REQUIRE(machine.Event == 2);
+        REQUIRE(dispatch_event_budget(machineList, 1, 0) == EVENT_HANDLED);
+        REQUIRE(invocations == 10);
+      }
+    }
+
+    WHEN("Handler keeps triggering the event to self in bounded dispatch")
+    {
+      machine.State = &testHSM[0];
+      machine.Event = 1;
+
+      uint32_t invocations = 0;
+      MockRepository mocks;
+      mocks.OnCallFunc(handler).With(&machine).Do(
+        [&invocations](state_machine_t * const pMachine)
+        {
+          invocations++;
+          pMachine->Event = 2;
+          return TRIGGERED_TO_SELF;
+        });
+
+      THEN( "dispatcher returns after the maximum number of events" )
+      {
+        REQUIRE(dispatch_event_bounded(machineList, 1, 3, NULL, 0) == BUDGET_EXHAUSTED);
+        REQUIRE(invocations == 3);
+        REQUIRE(machine.Event == 2);
+      }
+
+      THEN( "dispatcher returns when the deadline is reached, even if clock wraps around" )
+      {
+        Now = 0xFFFFFFFE;
+        REQUIRE(dispatch_event_bounded(machineList, 1, 0, tick_clock, 2) == BUDGET_EXHAUSTED);
+        REQUIRE(invocations == 4);
+        REQUIRE(machine.Event == 2);
+      }
+    }
+
+    WHEN("event is handled within the limits of bounded dispatch")
+    {
+      machine.State = &testHSM[0];
+      machine.Event = 1;
+      Now = 0;
+
+      THEN( "dispatcher returns after all events are handled" )
+      {
+        REQUIRE(dispatch_event_bounded(machineList, 1, 3, tick_clock, 10) == EVENT_HANDLED);
+        REQUIRE(machine.Event == 0);
+      }
+    }
   }
 }
 
@@ -69,7 +69,7 @@ SCENARIO("Finite state machine transition")
   GIVEN( "A simple finite state machine" )
   {
 
-    state_machine_t machine;
+    state_machine_t machine = {};
     machine.State = testHSM;
     WHEN( "State transition using \"switch_state\"" )
     {
@@ -97,6 +97,32 @@ SCENARIO("Finite state machine transition")
       }
     }
     #endif // HIERARCHICAL_STATES
+#if HSM_PUBLISH_STATE
+    WHEN( "State transition is in progress" )
+    {
+      set_state(&machine, testHSM);
+      MockRepository mocks;
+      mocks.ExpectCallFunc(handler1Exit).With(&machine).Do(
+        [](state_machine_t * const pMachine)
+        {
+          REQUIRE(pMachine->State == &testHSM[1]);
+          REQUIRE(observe_state(pMachine) == &testHSM[0]);
+          return EVENT_HANDLED;
+        });
+      mocks.ExpectCallFunc(handler2Entry).With(&machine).Do(
+        [](state_machine_t * const pMachine)
+        {
+          REQUIRE(observe_state(pMachine) == &testHSM[0]);
+          return EVENT_HANDLED;
+        });
+
+      THEN("observers see the state of last completed run to completion step")
+      {
+        REQUIRE((switch_state(&machine, &testHSM[1])) == EVENT_HANDLED);
+        REQUIRE(observe_state(&machine) == &testHSM[0]);
+      }
+    }
+#endif // HSM_PUBLISH_STATE
     WHEN("Entry handler triggers event to self")
     {
       MockRepository mocks;
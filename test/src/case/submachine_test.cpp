@@ -0,0 +1,246 @@
+/**
+ * \file
+ * \brief Test of submachine shared by multiple composite states
+
+ * \author  Nandkishor Biradar
+ * \date  19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+#include <cstdint>
+#include <string>
+
+#include "catch.hpp"
+
+#include "hsm.h"
+
+namespace submachine_test
+{
+
+#if HSM_SUBMACHINE
+
+enum event_t
+{
+  TOGGLE = 1,
+  STOP,
+};
+
+//! User derived state machine that records the entry and exit actions
+struct heater_t
+{
+  state_machine_t Machine;
+  std::string Trace;
+};
+
+extern const state_t Root_HSM[3];
+extern const state_t Switch_HSM[2];
+
+void trace(state_machine_t* const pState_Machine, char action)
+{
+  reinterpret_cast<heater_t*>(pState_Machine)->Trace += action;
+}
+
+state_machine_result_t idle_handler(state_machine_t * const)
+{
+  return EVENT_HANDLED;
+}
+
+state_machine_result_t heater_handler(state_machine_t * const pState_Machine)
+{
+  if(pState_Machine->Event == STOP)
+  {
+    return traverse_state(pState_Machine, &Root_HSM[0]);
+  }
+  return EVENT_UN_HANDLED;
+}
+
+state_machine_result_t heater1_entry(state_machine_t * const pState_Machine)
+{
+  trace(pState_Machine, 'H');
+  return EVENT_HANDLED;
+}
+
+state_machine_result_t heater1_exit(state_machine_t * const pState_Machine)
+{
+  trace(pState_Machine, 'h');
+  return EVENT_HANDLED;
+}
+
+state_machine_result_t heater2_entry(state_machine_t * const pState_Machine)
+{
+  trace(pState_Machine, 'G');
+  return EVENT_HANDLED;
+}
+
+state_machine_result_t heater2_exit(state_machine_t * const pState_Machine)
+{
+  trace(pState_Machine, 'g');
+  return EVENT_HANDLED;
+}
+
+state_machine_result_t off_handler(state_machine_t * const pState_Machine)
+{
+  if(pState_Machine->Event == TOGGLE)
+  {
+    return traverse_state(pState_Machine, &Switch_HSM[1]);
+  }
+  return EVENT_UN_HANDLED;
+}
+
+state_machine_result_t on_handler(state_machine_t * const pState_Machine)
+{
+  if(pState_Machine->Event == TOGGLE)
+  {
+    return traverse_state(pState_Machine, &Switch_HSM[0]);
+  }
+  return EVENT_UN_HANDLED;
+}
+
+state_machine_result_t off_entry(state_machine_t * const pState_Machine)
+{
+  trace(pState_Machine, 'O');
+  return EVENT_HANDLED;
+}
+
+state_machine_result_t off_exit(state_machine_t * const pState_Machine)
+{
+  trace(pState_Machine, 'o');
+  return EVENT_HANDLED;
+}
+
+state_machine_result_t on_entry(state_machine_t * const pState_Machine)
+{
+  trace(pState_Machine, 'N');
+  return EVENT_HANDLED;
+}
+
+state_machine_result_t on_exit(state_machine_t * const pState_Machine)
+{
+  trace(pState_Machine, 'n');
+  return EVENT_HANDLED;
+}
+
+const state_t Root_HSM[3] =
+{
+  {
+    idle_handler,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    0
+  },
+  {
+    heater_handler,
+    heater1_entry,
+    heater1_exit,
+    NULL,
+    Switch_HSM,
+    0
+  },
+  {
+    heater_handler,
+    heater2_entry,
+    heater2_exit,
+    NULL,
+    Switch_HSM,
+    0
+  }
+};
+
+//! Submachine shared by both the heater states
+const state_t Switch_HSM[2] =
+{
+  {
+    off_handler,
+    off_entry,
+    off_exit,
+    SUBMACHINE_PARENT,
+    NULL,
+    SUBMACHINE_LEVEL(0)
+  },
+  {
+    on_handler,
+    on_entry,
+    on_exit,
+    SUBMACHINE_PARENT,
+    NULL,
+    SUBMACHINE_LEVEL(0)
+  }
+};
+
+state_machine_result_t dispatch(heater_t& heater, uint32_t event)
+{
+  state_machine_t* const machines[] = {&heater.Machine};
+  heater.Machine.Event = event;
+  return dispatch_event(machines, 1);
+}
+
+SCENARIO("Submachine shared by composite states")
+{
+  GIVEN( "A state machine in idle state" )
+  {
+    heater_t heater = {};
+    set_state(&heater.Machine, &Root_HSM[0]);
+    clear_transition_cache();
+
+    WHEN( "it enters the submachine of first heater" )
+    {
+      REQUIRE(enter_submachine(&heater.Machine, &Root_HSM[1], &Switch_HSM[0]) == EVENT_HANDLED);
+
+      THEN( "host state is entered before the submachine state" )
+      {
+        REQUIRE(heater.Trace == "HO");
+        REQUIRE(get_state(&heater.Machine) == &Switch_HSM[0]);
+        REQUIRE(heater.Machine.Context == &Root_HSM[1]);
+      }
+
+      THEN( "transition within the submachine keeps the host state" )
+      {
+        heater.Trace.clear();
+        REQUIRE(dispatch(heater, TOGGLE) == EVENT_HANDLED);
+        REQUIRE(heater.Trace == "oN");
+        REQUIRE(get_state(&heater.Machine) == &Switch_HSM[1]);
+        REQUIRE(heater.Machine.Context == &Root_HSM[1]);
+      }
+
+      THEN( "unhandled event is handled by the host state" )
+      {
+        heater.Trace.clear();
+        REQUIRE(dispatch(heater, STOP) == EVENT_HANDLED);
+        REQUIRE(heater.Trace == "oh");
+        REQUIRE(get_state(&heater.Machine) == &Root_HSM[0]);
+        REQUIRE(heater.Machine.Context == NULL);
+      }
+
+      THEN( "same submachine state in other host is a different state" )
+      {
+        for(uint32_t count = 0; count < 2; count++)
+        {
+          heater.Trace.clear();
+          REQUIRE(enter_submachine(&heater.Machine, &Root_HSM[2], &Switch_HSM[0]) == EVENT_HANDLED);
+          REQUIRE(heater.Trace == "ohGO");
+          REQUIRE(heater.Machine.Context == &Root_HSM[2]);
+
+          heater.Trace.clear();
+          REQUIRE(enter_submachine(&heater.Machine, &Root_HSM[1], &Switch_HSM[0]) == EVENT_HANDLED);
+          REQUIRE(heater.Trace == "ogHO");
+          REQUIRE(heater.Machine.Context == &Root_HSM[1]);
+        }
+
+        // Re-entering from the same host is a self transition.
+        heater.Trace.clear();
+        REQUIRE(enter_submachine(&heater.Machine, &Root_HSM[1], &Switch_HSM[0]) == EVENT_HANDLED);
+        REQUIRE(heater.Trace == "oO");
+      }
+    }
+  }
+}
+#endif // HSM_SUBMACHINE
+
+}
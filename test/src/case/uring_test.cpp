@@ -0,0 +1,216 @@
+/**
+ * \file
+ * \brief Test of io_uring event source
+
+ * \author  Nandkishor Biradar
+ * \date  19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+#include <poll.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#include "catch.hpp"
+
+#include "hsm.h"
+#include "hsm_post.h"
+#include "hsm_linux.h"
+#include "hsm_uring.h"
+
+namespace uring_test
+{
+
+uint32_t Events[8];
+uint32_t Total_Events;
+
+state_machine_result_t handler(state_machine_t * const pState_Machine)
+{
+  Events[Total_Events++ % 8] = pState_Machine->Event;
+  return EVENT_HANDLED;
+}
+
+uint32_t Payloads[8];
+
+state_machine_result_t queued_handler(state_machine_t * const pState_Machine)
+{
+  Payloads[Total_Events % 8] = get_event_payload(pState_Machine);
+  return handler(pState_Machine);
+}
+
+SCENARIO("io_uring event source")
+{
+  const static state_t testHSM[1] =
+  {
+    handler,
+    NULL,
+    NULL,
+    #if HIERARCHICAL_STATES
+    NULL,
+    NULL,
+    0
+    #endif
+  };
+
+  const static state_t queuedHSM[1] =
+  {
+    queued_handler,
+    NULL,
+    NULL,
+    #if HIERARCHICAL_STATES
+    NULL,
+    NULL,
+    0
+    #endif
+  };
+
+  GIVEN( "An io_uring adapter with two state machines" )
+  {
+    state_machine_t machine1 = {}, machine2 = {};
+    state_machine_t * const machineList[] = {&machine1, &machine2};
+    machine1.State = testHSM;
+    machine2.State = testHSM;
+    int32_t results[2] = {-1, -1};
+    uring_adapter_t adapter;
+    Total_Events = 0;
+
+    if(init_uring(&adapter, 8, machineList, 2, results, -1) < 0)
+    {
+      WARN("io_uring is not available");
+      return;
+    }
+
+    WHEN( "requests of both state machines are completed" )
+    {
+      REQUIRE(uring_get_sqe(&adapter, 1, 4) != NULL);
+      REQUIRE(uring_get_sqe(&adapter, 0, 3) != NULL);
+      REQUIRE(uring_get_sqe(&adapter, 0, 5) != NULL);   // Second completion of same machine
+      REQUIRE(uring_submit(&adapter, 3) == 3);
+
+      THEN( "completions are dispatched as events" )
+      {
+        REQUIRE(uring_dispatch(&adapter) == EVENT_HANDLED);
+        REQUIRE(Total_Events == 3);
+        REQUIRE(Events[0] == 3);    // Higher priority state machine first
+        REQUIRE(Events[1] == 4);
+        REQUIRE(Events[2] == 5);
+        REQUIRE(results[0] == 0);
+        REQUIRE(results[1] == 0);
+        REQUIRE(machine1.Event == 0);
+        REQUIRE(machine2.Event == 0);
+      }
+    }
+
+    WHEN( "submission queue is full" )
+    {
+      for(uint32_t index = 0; index < adapter.Entries; index++)
+      {
+        REQUIRE(uring_get_sqe(&adapter, 0, 1) != NULL);
+      }
+
+      THEN( "it returns NULL" )
+      {
+        REQUIRE(uring_get_sqe(&adapter, 0, 1) == NULL);
+      }
+    }
+
+    close_uring(&adapter);
+  }
+
+  GIVEN( "An io_uring adapter with a state machine having event queue" )
+  {
+    state_machine_t machine = {};
+    state_machine_t * const machineList[] = {&machine};
+    machine.State = queuedHSM;
+    event_queue_t queue;
+    queued_event_t buffer[4 * HSM_QUEUE_LANES];
+    REQUIRE(init_event_queue(&machine, &queue, buffer, 4));
+    int32_t results[1] = {-1};
+    uring_adapter_t adapter;
+    int pipeFd[2];
+    char data[4] = {};
+    Total_Events = 0;
+
+    if(init_uring(&adapter, 4, machineList, 1, results, -1) < 0)
+    {
+      WARN("io_uring is not available");
+      return;
+    }
+    REQUIRE(pipe(pipeFd) == 0);
+
+    WHEN( "two requests of the state machine are completed before dispatch" )
+    {
+      struct iovec vector[2] = {{data, 1}, {data, 2}};
+      for(uint32_t index = 0; index < 2; index++)
+      {
+        struct io_uring_sqe* const pSqe = uring_get_sqe(&adapter, 0, index + 1);
+        REQUIRE(pSqe != NULL);
+        pSqe->opcode = IORING_OP_WRITEV;
+        pSqe->fd = pipeFd[1];
+        pSqe->addr = (uint64_t)(uintptr_t)&vector[index];
+        pSqe->len = 1;
+      }
+      REQUIRE(uring_submit(&adapter, 2) == 2);
+
+      THEN( "each event is dispatched with result of its own completion" )
+      {
+        REQUIRE(uring_dispatch(&adapter) == EVENT_HANDLED);
+        REQUIRE(Total_Events == 2);
+        REQUIRE(Events[0] == 1);
+        REQUIRE(Payloads[0] == 1);
+        REQUIRE(Events[1] == 2);
+        REQUIRE(Payloads[1] == 2);
+        REQUIRE(results[0] == -1);
+      }
+    }
+
+    close(pipeFd[0]);
+    close(pipeFd[1]);
+    close_uring(&adapter);
+  }
+
+  GIVEN( "io_uring adapter attached to Linux runtime" )
+  {
+    state_machine_t machine = {};
+    state_machine_t * const machineList[] = {&machine};
+    machine.State = testHSM;
+    linux_runtime_t runtime;
+    uring_adapter_t adapter;
+    Total_Events = 0;
+
+    const int fd = init_runtime(&runtime, machineList, 1, NULL, 0);
+    REQUIRE(fd >= 0);
+    if(init_uring(&adapter, 4, machineList, 1, NULL, runtime.Event_Fd) < 0)
+    {
+      WARN("io_uring is not available");
+      close_runtime(&runtime);
+      return;
+    }
+
+    WHEN( "request is completed" )
+    {
+      REQUIRE(uring_get_sqe(&adapter, 0, 7) != NULL);
+      REQUIRE(uring_submit(&adapter, 0) == 1);
+
+      THEN( "runtime descriptor becomes readable" )
+      {
+        struct pollfd pollFd = {fd, POLLIN, 0};
+        REQUIRE(poll(&pollFd, 1, 1000) == 1);
+        REQUIRE(runtime_dispatch(&runtime) == EVENT_HANDLED);
+        REQUIRE(uring_dispatch(&adapter) == EVENT_HANDLED);
+        REQUIRE(Total_Events == 1);
+        REQUIRE(Events[0] == 7);
+      }
+    }
+
+    close_uring(&adapter);
+    close_runtime(&runtime);
+  }
+}
+
+}
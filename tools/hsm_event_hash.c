@@ -0,0 +1,629 @@
+/**
+ * \file
+ * \brief Generator of minimal perfect hash of event names.
+ *
+ *  Usage: hsm_event_hash <header> <enum> <prefix> <output>
+ *  Reads the members of enum type from the header and writes a header with an inline
+ *  decode_<enum without _t> function, that converts an event name to the enum value
+ *  with one hash of the name and one string compare. Only the members starting with the
+ *  prefix are included, name of an event is the member without prefix in lower case,
+ *  e.g. EN_DOOR_OPEN with prefix EN_ is "door_open".
+ *
+ *  Each name is hashed once, the hash selects a bucket and the displacement of bucket
+ *  selects the slot. Displacements are searched at build time, so that every name has its
+ *  own slot and there are as many slots as names.
+
+ * \author  Nandkishor Biradar
+ * \date    19 October 2026
+
+ *  Copyright (c) 2018-2026 Nandkishor Biradar
+ *  https://github.com/kiishor
+
+ *  Distributed under the MIT License, (See accompanying
+ *  file LICENSE or copy at https://mit-license.org/)
+ */
+
+/*
+ *  --------------------- INCLUDE FILES ---------------------
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+/*
+ *  --------------------- DEFINITION ---------------------
+ */
+
+//! Maximum number of names in the enum
+#define MAX_NAMES           4096u
+
+//! Maximum length of identifier
+#define MAX_IDENTIFIER      255u
+
+//! Maximum displacement of a bucket, it is stored as uint16_t.
+#define MAX_DISPLACEMENT    UINT16_MAX
+
+/*
+ *  --------------------- STRUCTURE ---------------------
+ */
+
+//! Member of enum
+typedef struct
+{
+  char Member[MAX_IDENTIFIER + 1];    //!< Identifier of enum member
+  char Name[MAX_IDENTIFIER + 1];      //!< Event name
+  uint32_t Hash;                      //!< Hash of event name
+  uint32_t Bucket;                    //!< Bucket of event name
+}event_name_t;
+
+/*
+ *  --------------------- Global variables ---------------------
+ */
+
+static event_name_t Names[MAX_NAMES];
+static uint32_t Total_Names;
+static uint32_t* Bucket_Size;   //!< Number of names in each bucket
+
+/*
+ *  --------------------- Functions ---------------------
+ */
+
+/*
+ * Hash functions are copied into the generated header, keep both in sync.
+ */
+
+//! Mix 4 bytes (little endian) of name into hash. Result doesn't depend on the byte order of host.
+static inline uint32_t mix_word(uint32_t hash, const uint8_t* const pByte)
+{
+  const uint32_t word = (uint32_t)pByte[0] | ((uint32_t)pByte[1] << 8)
+                        | ((uint32_t)pByte[2] << 16) | ((uint32_t)pByte[3] << 24);
+  hash = (hash ^ word) * 0x9E3779B1u;
+  return hash ^ (hash >> 15);
+}
+
+//! Hash of name, 4 bytes per step. Last word overlaps the previous one, so there is no loop over remaining bytes.
+static uint32_t hash_name(const char* const pName, size_t length)
+{
+  const uint8_t* const pByte = (const uint8_t*)pName;
+  uint32_t hash = 2166136261u ^ (uint32_t)length;
+  if(length >= 4)
+  {
+    for(size_t index = 0; (index + 4) < length; index += 4)
+    {
+      hash = mix_word(hash, &pByte[index]);
+    }
+    hash = mix_word(hash, &pByte[length - 4]);
+  }
+  else if(length != 0)
+  {
+    const uint8_t word[4] = {pByte[0], pByte[length >> 1], pByte[length - 1], 0};
+    hash = mix_word(hash, word);
+  }
+  return hash ^ (hash >> 16);
+}
+
+//! Mix the hash with seed and reduce it to [0, range).
+static uint32_t reduce_hash(uint32_t hash, uint32_t seed, uint32_t range)
+{
+  hash = (hash ^ seed) * 0x85EBCA6Bu;
+  hash ^= hash >> 13;
+  return (uint32_t)(((uint64_t)hash * range) >> 32);
+}
+
+static const char Mix_Source[] =
+  "  const uint32_t word = (uint32_t)pByte[0] | ((uint32_t)pByte[1] << 8)\n"
+  "                        | ((uint32_t)pByte[2] << 16) | ((uint32_t)pByte[3] << 24);\n"
+  "  hash = (hash ^ word) * 0x9E3779B1u;\n"
+  "  return hash ^ (hash >> 15);\n";
+
+static const char Hash_Source[] =
+  "  const uint8_t* const pByte = (const uint8_t*)pName;\n"
+  "  uint32_t hash = 2166136261u ^ (uint32_t)length;\n"
+  "  if(length >= 4)\n"
+  "  {\n"
+  "    for(size_t index = 0; (index + 4) < length; index += 4)\n"
+  "    {\n"
+  "      hash = mix_%s_word(hash, &pByte[index]);\n"
+  "    }\n"
+  "    hash = mix_%s_word(hash, &pByte[length - 4]);\n"
+  "  }\n"
+  "  else if(length != 0)\n"
+  "  {\n"
+  "    const uint8_t word[4] = {pByte[0], pByte[length >> 1], pByte[length - 1], 0};\n"
+  "    hash = mix_%s_word(hash, word);\n"
+  "  }\n"
+  "  return hash ^ (hash >> 16);\n";
+
+static const char Reduce_Source[] =
+  "  hash = (hash ^ seed) * 0x85EBCA6Bu;\n"
+  "  hash ^= hash >> 13;\n"
+  "  return (uint32_t)(((uint64_t)hash * range) >> 32);\n";
+
+//! Returns the content of file, NULL on error.
+static char* read_file(const char* const pPath)
+{
+  FILE* const pFile = fopen(pPath, "rb");
+  if(pFile == NULL)
+  {
+    return NULL;
+  }
+
+  size_t size = 0;
+  size_t capacity = 4096;
+  char* pText = malloc(capacity);
+  while(pText != NULL)
+  {
+    size += fread(pText + size, 1, capacity - size - 1, pFile);
+    if(size < capacity - 1)
+    {
+      pText[size] = '\0';
+      break;
+    }
+    capacity *= 2;
+    char* const pLarger = realloc(pText, capacity);
+    if(pLarger == NULL)
+    {
+      free(pText);
+    }
+    pText = pLarger;
+  }
+  fclose(pFile);
+  return pText;
+}
+
+//! Replace the comments and preprocessor lines with spaces, so that they are not parsed.
+static void strip_comments(char* pText)
+{
+  bool lineStart = true;
+  while(*pText != '\0')
+  {
+    if((pText[0] == '/') && (pText[1] == '/'))
+    {
+      while((*pText != '\0') && (*pText != '\n'))
+      {
+        *pText++ = ' ';
+      }
+    }
+    else if((pText[0] == '/') && (pText[1] == '*'))
+    {
+      while((*pText != '\0') && !((pText[0] == '*') && (pText[1] == '/')))
+      {
+        if(*pText != '\n')
+        {
+          *pText = ' ';
+        }
+        pText++;
+      }
+      if(*pText != '\0')
+      {
+        pText[0] = pText[1] = ' ';
+        pText += 2;
+      }
+    }
+    else if(lineStart && (*pText == '#'))
+    {
+      while((*pText != '\0') && (*pText != '\n'))
+      {
+        *pText++ = ' ';
+      }
+    }
+    else if(*pText == '"')
+    {
+      do
+      {
+        pText += ((pText[0] == '\\') && (pText[1] != '\0')) ? 2 : 1;
+      }while((*pText != '\0') && (*pText != '"') && (*pText != '\n'));
+      if(*pText == '"')
+      {
+        pText++;
+      }
+    }
+    else
+    {
+      if(*pText == '\n')
+      {
+        lineStart = true;
+      }
+      else if(!isspace((unsigned char)*pText))
+      {
+        lineStart = false;
+      }
+      pText++;
+    }
+  }
+}
+
+static inline bool is_identifier(char character)
+{
+  return isalnum((unsigned char)character) || (character == '_');
+}
+
+//! Skip the white spaces and read the identifier. Returns the length of identifier, 0 if there is none.
+static size_t read_identifier(const char** const ppText, char* const pIdentifier)
+{
+  const char* pText = *ppText;
+  while(isspace((unsigned char)*pText))
+  {
+    pText++;
+  }
+
+  size_t length = 0;
+  if(!isdigit((unsigned char)*pText))
+  {
+    while(is_identifier(pText[length]) && (length < MAX_IDENTIFIER))
+    {
+      pIdentifier[length] = pText[length];
+      length++;
+    }
+  }
+  pIdentifier[length] = '\0';
+  *ppText = pText + length;
+  return length;
+}
+
+/** \brief Find the body of enum type, in "typedef enum [tag] {...} name;" or "enum name {...};" form.
+ *
+ * \param pText const char*         header without comments
+ * \param pEnum const char* const   name of enum type or tag
+ * \param ppEnd const char**        end of body ('}')
+ * \return const char*              start of body (after '{'), NULL if enum is not found.
+ *
+ */
+static const char* find_enum(const char* const pText, const char* const pEnum, const char** ppEnd)
+{
+  char identifier[MAX_IDENTIFIER + 1];
+  const char* pMatch = pText;
+  while((pMatch = strstr(pMatch, "enum")) != NULL)
+  {
+    const char* pStart = pMatch + 4;
+    const bool keyword = ((pMatch == pText) || !is_identifier(pMatch[-1])) && !is_identifier(pStart[0]);
+    pMatch = pStart;
+    if(!keyword)
+    {
+      continue;
+    }
+
+    const bool tagged = (read_identifier(&pStart, identifier) != 0) && (strcmp(identifier, pEnum) == 0);
+    while(isspace((unsigned char)*pStart))
+    {
+      pStart++;
+    }
+    if(*pStart != '{')
+    {
+      continue;
+    }
+
+    const char* const pBody = pStart + 1;
+    const char* const pEnd = strchr(pBody, '}');
+    if(pEnd == NULL)
+    {
+      return NULL;
+    }
+
+    const char* pName = pEnd + 1;
+    if(tagged || ((read_identifier(&pName, identifier) != 0) && (strcmp(identifier, pEnum) == 0)))
+    {
+      *ppEnd = pEnd;
+      return pBody;
+    }
+    pMatch = pEnd;
+  }
+  return NULL;
+}
+
+//! Read the members of enum body that start with prefix. Returns false on error.
+static bool read_members(const char* pText, const char* const pEnd, const char* const pPrefix)
+{
+  const size_t prefixLength = strlen(pPrefix);
+  while(pText < pEnd)
+  {
+    char member[MAX_IDENTIFIER + 1];
+    const size_t length = read_identifier(&pText, member);
+    if(length == 0)
+    {
+      break;
+    }
+
+    if((strncmp(member, pPrefix, prefixLength) == 0) && (length > prefixLength))
+    {
+      if(Total_Names == MAX_NAMES)
+      {
+        fprintf(stderr, "hsm_event_hash: more than %u names\n", MAX_NAMES);
+        return false;
+      }
+
+      event_name_t* const pName = &Names[Total_Names++];
+      strcpy(pName->Member, member);
+      for(size_t index = prefixLength; index <= length; index++)
+      {
+        pName->Name[index - prefixLength] = (char)tolower((unsigned char)member[index]);
+      }
+      pName->Hash = hash_name(pName->Name, length - prefixLength);
+    }
+
+    // Skip the value of member
+    uint32_t depth = 0;
+    while((pText < pEnd) && ((*pText != ',') || (depth != 0)))
+    {
+      depth += (*pText == '(');
+      depth -= (*pText == ')') && (depth != 0);
+      pText++;
+    }
+    pText++;
+  }
+  return true;
+}
+
+//! Sort the buckets by decreasing number of names, larger buckets are placed first.
+static int compare_bucket(const void* pFirst, const void* pSecond)
+{
+  const uint32_t first = Bucket_Size[*(const uint32_t*)pFirst];
+  const uint32_t second = Bucket_Size[*(const uint32_t*)pSecond];
+  return (first < second) - (first > second);
+}
+
+/** \brief Search the displacement of each bucket, so that all the names have distinct slots.
+ *
+ * \param pDisplacement uint16_t* const   displacement of each bucket
+ * \param pSlot uint32_t* const           name index of each slot
+ * \return bool false if there is no displacement for a bucket.
+ *
+ */
+static bool place_names(uint16_t* const pDisplacement, uint32_t* const pSlot)
+{
+  const uint32_t total = Total_Names;
+  uint32_t* const pOrder = malloc(total * sizeof(uint32_t));
+  uint32_t* const pCandidate = malloc(total * sizeof(uint32_t));
+  Bucket_Size = calloc(total, sizeof(uint32_t));
+  if((pOrder == NULL) || (pCandidate == NULL) || (Bucket_Size == NULL))
+  {
+    return false;
+  }
+
+  for(uint32_t index = 0; index < total; index++)
+  {
+    Names[index].Bucket = reduce_hash(Names[index].Hash, 0, total);
+    Bucket_Size[Names[index].Bucket]++;
+    pOrder[index] = index;
+    pDisplacement[index] = 0;
+    pSlot[index] = UINT32_MAX;
+  }
+  qsort(pOrder, total, sizeof(uint32_t), compare_bucket);
+
+  bool placed = true;
+  for(uint32_t order = 0; (order < total) && (Bucket_Size[pOrder[order]] != 0) && placed; order++)
+  {
+    const uint32_t bucket = pOrder[order];
+    placed = false;
+    for(uint32_t seed = 1; (seed <= MAX_DISPLACEMENT) && !placed; seed++)
+    {
+      uint32_t count = 0;
+      placed = true;
+      for(uint32_t index = 0; (index < total) && placed; index++)
+      {
+        if(Names[index].Bucket != bucket)
+        {
+          continue;
+        }
+
+        const uint32_t slot = reduce_hash(Names[index].Hash, seed, total);
+        for(uint32_t other = 0; other < count; other++)
+        {
+          placed = placed && (pCandidate[other] != slot);
+        }
+        placed = placed && (pSlot[slot] == UINT32_MAX);
+        pCandidate[count++] = slot;
+      }
+
+      if(placed)
+      {
+        pDisplacement[bucket] = (uint16_t)seed;
+        count = 0;
+        for(uint32_t index = 0; index < total; index++)
+        {
+          if(Names[index].Bucket == bucket)
+          {
+            pSlot[pCandidate[count++]] = index;
+          }
+        }
+      }
+    }
+  }
+
+  free(Bucket_Size);
+  free(pCandidate);
+  free(pOrder);
+  return placed;
+}
+
+//! Returns the base name of path.
+static const char* get_base_name(const char* const pPath)
+{
+  const char* pBase = pPath;
+  for(const char* pText = pPath; *pText != '\0'; pText++)
+  {
+    if((*pText == '/') || (*pText == '\\'))
+    {
+      pBase = pText + 1;
+    }
+  }
+  return pBase;
+}
+
+//! Write the generated header. Returns false on error.
+static bool write_header(const char* const pPath, const char* const pHeader, const char* const pEnum,
+                         const uint16_t* const pDisplacement, const uint32_t* const pSlot)
+{
+  // Name of functions and tables is the enum type without _t suffix.
+  char name[MAX_IDENTIFIER + 1];
+  char upper[MAX_IDENTIFIER + 1];
+  char title[MAX_IDENTIFIER + 1];
+  size_t length = strlen(pEnum);
+  if((length > 2) && (strcmp(pEnum + length - 2, "_t") == 0))
+  {
+    length -= 2;
+  }
+  for(size_t index = 0; index <= length; index++)
+  {
+    const char character = (index < length) ? pEnum[index] : '\0';
+    const bool wordStart = (index == 0) || (pEnum[index - 1] == '_');
+    name[index] = character;
+    upper[index] = (char)toupper((unsigned char)character);
+    title[index] = wordStart ? upper[index] : character;
+  }
+
+  FILE* const pFile = fopen(pPath, "w");
+  if(pFile == NULL)
+  {
+    return false;
+  }
+
+  const uint32_t total = Total_Names;
+  fprintf(pFile,
+          "/**\n"
+          " * \\file\n"
+          " * \\brief Minimal perfect hash of %s names.\n"
+          " *  Generated by hsm_event_hash from %s, do not edit.\n"
+          " *  Include it after the definition of %s.\n"
+          " */\n\n"
+          "#ifndef %s_HASH_H\n"
+          "#define %s_HASH_H\n\n"
+          "#include <stdint.h>\n"
+          "#include <stddef.h>\n"
+          "#include <string.h>\n\n"
+          "//! Number of %s names\n"
+          "#define %s_NAMES    %uu\n\n",
+          pEnum, get_base_name(pHeader), pEnum, upper, upper, pEnum, upper, total);
+
+  fprintf(pFile, "static const uint16_t %s_Displacement[%s_NAMES] =\n{", title, upper);
+  for(uint32_t index = 0; index < total; index++)
+  {
+    fprintf(pFile, "%s%u,", ((index % 16) == 0) ? "\n  " : " ", pDisplacement[index]);
+  }
+  fprintf(pFile, "\n};\n\nstatic const uint8_t %s_Length[%s_NAMES] =\n{", title, upper);
+  for(uint32_t index = 0; index < total; index++)
+  {
+    fprintf(pFile, "%s%u,", ((index % 16) == 0) ? "\n  " : " ", (unsigned)strlen(Names[pSlot[index]].Name));
+  }
+  fprintf(pFile, "\n};\n\nstatic const char* const %s_Name[%s_NAMES] =\n{\n", title, upper);
+  for(uint32_t index = 0; index < total; index++)
+  {
+    fprintf(pFile, "  \"%s\",\n", Names[pSlot[index]].Name);
+  }
+  fprintf(pFile, "};\n\nstatic const uint32_t %s_Value[%s_NAMES] =\n{\n", title, upper);
+  for(uint32_t index = 0; index < total; index++)
+  {
+    fprintf(pFile, "  (uint32_t)%s,\n", Names[pSlot[index]].Member);
+  }
+
+  fprintf(pFile,
+          "};\n\n"
+          "//! Mix 4 bytes (little endian) of name into hash.\n"
+          "static inline uint32_t mix_%s_word(uint32_t hash, const uint8_t* const pByte)\n"
+          "{\n%s}\n\n"
+          "//! Returns the hash of name.\n"
+          "static inline uint32_t hash_%s_name(const char* const pName, size_t length)\n"
+          "{\n",
+          name, Mix_Source, name);
+  fprintf(pFile, Hash_Source, name, name, name);
+  fprintf(pFile,
+          "}\n\n"
+          "//! Mix the hash with seed and reduce it to [0, range).\n"
+          "static inline uint32_t reduce_%s_hash(uint32_t hash, uint32_t seed, uint32_t range)\n"
+          "{\n%s}\n\n",
+          name, Reduce_Source);
+
+  fprintf(pFile,
+          "/** \\brief Decode the event name to %s value.\n"
+          " *\n"
+          " * \\param pName const char* const   event name, need not be null terminated\n"
+          " * \\param length size_t             length of name\n"
+          " * \\return uint32_t                 value of event, 0 (no event) if name is unknown\n"
+          " *\n"
+          " */\n"
+          "static inline uint32_t decode_%s(const char* const pName, size_t length)\n"
+          "{\n"
+          "  const uint32_t hash = hash_%s_name(pName, length);\n"
+          "  const uint32_t bucket = reduce_%s_hash(hash, 0, %s_NAMES);\n"
+          "  const uint32_t slot = reduce_%s_hash(hash, %s_Displacement[bucket], %s_NAMES);\n"
+          "  if((%s_Length[slot] != length) || (memcmp(%s_Name[slot], pName, length) != 0))\n"
+          "  {\n"
+          "    return 0;\n"
+          "  }\n"
+          "  return %s_Value[slot];\n"
+          "}\n\n"
+          "#endif // %s_HASH_H\n",
+          pEnum, name, name, name, upper, name, title, upper, title, title, title, upper);
+
+  return fclose(pFile) == 0;
+}
+
+int main(int argc, char* argv[])
+{
+  if(argc != 5)
+  {
+    fprintf(stderr, "usage: hsm_event_hash <header> <enum> <prefix> <output>\n");
+    return EXIT_FAILURE;
+  }
+
+  char* const pText = read_file(argv[1]);
+  if(pText == NULL)
+  {
+    fprintf(stderr, "hsm_event_hash: can't read %s\n", argv[1]);
+    return EXIT_FAILURE;
+  }
+  strip_comments(pText);
+
+  const char* pEnd;
+  const char* const pBody = find_enum(pText, argv[2], &pEnd);
+  if(pBody == NULL)
+  {
+    fprintf(stderr, "hsm_event_hash: enum %s is not found in %s\n", argv[2], argv[1]);
+    return EXIT_FAILURE;
+  }
+  if(!read_members(pBody, pEnd, argv[3]))
+  {
+    return EXIT_FAILURE;
+  }
+  if(Total_Names == 0)
+  {
+    fprintf(stderr, "hsm_event_hash: enum %s has no member with prefix %s\n", argv[2], argv[3]);
+    return EXIT_FAILURE;
+  }
+
+  for(uint32_t index = 0; index < Total_Names; index++)
+  {
+    for(uint32_t other = 0; other < index; other++)
+    {
+      if(Names[index].Hash == Names[other].Hash)
+      {
+        fprintf(stderr, "hsm_event_hash: %s and %s have the same hash\n", Names[index].Name, Names[other].Name);
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  uint16_t* const pDisplacement = malloc(Total_Names * sizeof(uint16_t));
+  uint32_t* const pSlot = malloc(Total_Names * sizeof(uint32_t));
+  if((pDisplacement == NULL) || (pSlot == NULL) || !place_names(pDisplacement, pSlot))
+  {
+    fprintf(stderr, "hsm_event_hash: can't place the names of %s\n", argv[2]);
+    return EXIT_FAILURE;
+  }
+
+  if(!write_header(argv[4], argv[1], argv[2], pDisplacement, pSlot))
+  {
+    fprintf(stderr, "hsm_event_hash: can't write %s\n", argv[4]);
+    return EXIT_FAILURE;
+  }
+
+  free(pSlot);
+  free(pDisplacement);
+  free(pText);
+  return EXIT_SUCCESS;
+}